@@ -0,0 +1,104 @@
+# Turns the sprite sheet's atlas.json into a header of constexpr frame rects, so the stock atlas
+# needs no JSON parsing at startup.
+#
+#   cmake -DATLAS_JSON=assets/sprites/atlas.json -DOUTPUT=generated/AtlasFrames.h -P GenerateAtlasFrames.cmake
+#
+# Each frame name becomes an AtlasFrame enumerator ("ghost_red" -> GhostRed). The JSON text is
+# embedded too: SpriteAtlas compares the atlas.json it loads against it and only parses files
+# that differ (modded atlases).
+cmake_minimum_required(VERSION 3.19) # string(JSON)
+
+if(NOT DEFINED ATLAS_JSON OR NOT DEFINED OUTPUT)
+    message(FATAL_ERROR "Usage: cmake -DATLAS_JSON=<atlas.json> -DOUTPUT=<header> -P GenerateAtlasFrames.cmake")
+endif()
+
+file(READ "${ATLAS_JSON}" _json)
+
+string(JSON _frames_type ERROR_VARIABLE _error TYPE "${_json}" frames)
+if(_error OR NOT _frames_type STREQUAL "OBJECT")
+    message(FATAL_ERROR "${ATLAS_JSON}: missing 'frames' object")
+endif()
+string(JSON _count LENGTH "${_json}" frames)
+if(_count EQUAL 0)
+    message(FATAL_ERROR "${ATLAS_JSON}: 'frames' is empty")
+endif()
+
+set(_enumerators "")
+set(_rects "")
+set(_seen "")
+math(EXPR _last "${_count} - 1")
+foreach(_i RANGE ${_last})
+    string(JSON _name MEMBER "${_json}" frames ${_i})
+
+    # snake_case -> PascalCase; anything that is not a letter or digit separates words.
+    string(REGEX REPLACE "[^A-Za-z0-9]+" ";" _words "${_name}")
+    set(_enumerator "")
+    foreach(_word IN LISTS _words)
+        string(SUBSTRING "${_word}" 0 1 _head)
+        string(SUBSTRING "${_word}" 1 -1 _tail)
+        string(TOUPPER "${_head}" _head)
+        string(APPEND _enumerator "${_head}${_tail}")
+    endforeach()
+    if(_enumerator MATCHES "^[0-9]")
+        set(_enumerator "Frame${_enumerator}")
+    endif()
+    if(_enumerator STREQUAL "" OR _enumerator IN_LIST _seen)
+        message(FATAL_ERROR "${ATLAS_JSON}: frame '${_name}' does not map to a unique enumerator")
+    endif()
+    list(APPEND _seen "${_enumerator}")
+
+    set(_fields "")
+    foreach(_key x y w h)
+        string(JSON _type ERROR_VARIABLE _error TYPE "${_json}" frames "${_name}" ${_key})
+        if(NOT _error)
+            string(JSON _value GET "${_json}" frames "${_name}" ${_key})
+        endif()
+        if(_error OR NOT _type STREQUAL "NUMBER" OR NOT _value MATCHES "^-?[0-9]+$")
+            message(FATAL_ERROR "${ATLAS_JSON}: frame '${_name}' needs an integer '${_key}'")
+        endif()
+        string(APPEND _fields ", ${_value}")
+    endforeach()
+
+    string(REPLACE "\\" "\\\\" _literal "${_name}")
+    string(REPLACE "\"" "\\\"" _literal "${_literal}")
+    string(APPEND _enumerators "    ${_enumerator},\n")
+    string(APPEND _rects "    {\"${_literal}\"${_fields}},\n")
+endforeach()
+
+# Escaped rather than a raw string: compilers normalise line endings inside raw strings, and the
+# comparison has to be byte for byte.
+string(REPLACE "\\" "\\\\" _source "${_json}")
+string(REPLACE "\"" "\\\"" _source "${_source}")
+string(REPLACE "\r" "\\r" _source "${_source}")
+string(REPLACE "\n" "\\n\"\n    \"" _source "${_source}")
+string(REGEX REPLACE "\"\n    \"$" "" _source "${_source}")
+
+file(WRITE "${OUTPUT}" "// Generated from atlas.json by cmake/GenerateAtlasFrames.cmake. Do not edit.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+enum class AtlasFrame : std::uint16_t {
+${_enumerators}};
+
+struct AtlasFrameRect {
+    std::string_view name;
+    int x;
+    int y;
+    int w;
+    int h;
+};
+
+constexpr std::size_t AtlasFrameCount = ${_count};
+
+// Indexed by AtlasFrame.
+constexpr std::array<AtlasFrameRect, AtlasFrameCount> AtlasFrameRects = {{
+${_rects}}};
+
+// The atlas.json this table was generated from.
+constexpr std::string_view AtlasFrameSource =
+    \"${_source}\";
+")
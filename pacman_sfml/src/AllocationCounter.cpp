@@ -0,0 +1,79 @@
+#include "AllocationCounter.h"
+
+#include <cstdlib>
+#include <new>
+
+namespace {
+// Trivially initialised, so it is safe to touch from operator new on any thread at any time.
+thread_local std::uint64_t tAllocations = 0;
+
+// What the standard operator new does: retry through the new-handler until it gives up.
+void* countedAlloc(std::size_t size) {
+    ++tAllocations;
+    if (size == 0) {
+        size = 1;
+    }
+    for (;;) {
+        if (void* p = std::malloc(size)) {
+            return p;
+        }
+        const std::new_handler handler = std::get_new_handler();
+        if (handler == nullptr) {
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+}
+
+void* countedAllocNothrow(std::size_t size) noexcept {
+    try {
+        return countedAlloc(size);
+    } catch (const std::bad_alloc&) {
+        return nullptr;
+    }
+}
+}
+
+std::uint64_t AllocationCounter::thisThread() {
+    return tAllocations;
+}
+
+void* operator new(std::size_t size) {
+    return countedAlloc(size);
+}
+
+void* operator new[](std::size_t size) {
+    return countedAlloc(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return countedAllocNothrow(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return countedAllocNothrow(size);
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, const std::nothrow_t&) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept {
+    std::free(p);
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstdint>
+
+// Counts heap allocations through the global operator new, per thread. The replacement
+// operator new/delete live in the pacman_alloc_counter object library; an executable that
+// links it directly counts every allocation: containers, std::string, SFML, std::function.
+// pacman_core code that reads the counter (SimulationThread) needs that library on the link
+// line too. Over-aligned new keeps the standard library version and is not counted.
+//
+// Diff thisThread() around a tick or a frame to check it does not touch the heap.
+class AllocationCounter {
+public:
+    // Allocations made by the calling thread since it started.
+    static std::uint64_t thisThread();
+};
@@ -0,0 +1,161 @@
+#include "AssetLoader.h"
+
+#include "Log.h"
+
+#include <SFML/Audio/InputSoundFile.hpp>
+
+#include <chrono>
+#include <fstream>
+#include <iterator>
+
+namespace {
+bool decodeImage(const AssetPack::Source& source, sf::Image& out) {
+    return source.packed ? out.loadFromMemory(source.packed.bytes, source.packed.size) : out.loadFromFile(source.path);
+}
+
+bool readText(const AssetPack::Source& source, std::string& out) {
+    if (source.packed) {
+        out.assign(source.packed.text());
+        return true;
+    }
+    std::ifstream in(source.path, std::ios::binary);
+    if (!in) {
+        return false;
+    }
+    out.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    return true;
+}
+
+bool decodeSound(const AssetPack* pack, const std::string& path, AssetLoader::SoundSamples& out) {
+    sf::InputSoundFile file;
+    const AssetPack::Source source = AssetPack::resolve(pack, path);
+    if (!(source.packed ? file.openFromMemory(source.packed.bytes, source.packed.size) : file.openFromFile(source.path))) {
+        PACMAN_LOG_ERROR("Failed to load sound: %s", path.c_str());
+        return false;
+    }
+    out.samples.resize(static_cast<std::size_t>(file.getSampleCount()));
+    out.samples.resize(static_cast<std::size_t>(file.read(out.samples.data(), out.samples.size())));
+    out.channelCount = file.getChannelCount();
+    out.sampleRate = file.getSampleRate();
+    if (out.samples.empty()) {
+        PACMAN_LOG_ERROR("Sound contains no samples: %s", path.c_str());
+        return false;
+    }
+    return true;
+}
+}
+
+AssetLoader::AssetLoader(const AssetPack* pack, unsigned threadCount) : mPack(pack), mPool(threadCount) {}
+
+AssetLoader::~AssetLoader() {
+    mPool.wait();
+}
+
+void AssetLoader::loadImage(const std::string& path, ImageReady onReady) {
+    request(Kind::Image, path, std::string(), [onReady = std::move(onReady)](const Job& job) {
+        onReady(job.ok ? &job.image : nullptr);
+    });
+}
+
+void AssetLoader::loadSpriteSheet(const std::string& imagePath, const std::string& jsonPath, SheetReady onReady) {
+    request(Kind::Sheet, imagePath, jsonPath, [onReady = std::move(onReady)](const Job& job) {
+        onReady(job.ok ? &job.frames : nullptr);
+    });
+}
+
+void AssetLoader::loadSound(const std::string& path, SoundReady onReady) {
+    request(Kind::Sound, path, std::string(), [onReady = std::move(onReady)](const Job& job) {
+        onReady(job.ok ? &job.sound : nullptr);
+    });
+}
+
+void AssetLoader::request(Kind kind, const std::string& path, const std::string& jsonPath, std::function<void(const Job&)> callback) {
+    ++mRequested;
+    // The same file decoded as an image and as a sheet yields different results; keep them apart.
+    const std::string key = std::to_string(static_cast<int>(kind)) + ':' + path + ':' + jsonPath;
+    auto it = mJobs.find(key);
+    if (it != mJobs.end()) {
+        Job& job = *it->second;
+        if (job.delivered) {
+            callback(job);
+            ++mDelivered;
+        } else {
+            job.callbacks.push_back(std::move(callback));
+        }
+        return;
+    }
+
+    auto job = std::make_unique<Job>();
+    job->kind = kind;
+    job->path = path;
+    job->jsonPath = jsonPath;
+    job->callbacks.push_back(std::move(callback));
+    Job* raw = job.get();
+    mJobs.emplace(key, std::move(job));
+
+    mPool.submit([this, raw] {
+        decode(*raw);
+        std::lock_guard<std::mutex> lock(mFinishedMutex);
+        mFinished.push_back(raw);
+    });
+}
+
+void AssetLoader::decode(Job& job) const {
+    const auto start = std::chrono::steady_clock::now();
+    switch (job.kind) {
+    case Kind::Image:
+        job.ok = decodeImage(AssetPack::resolve(mPack, job.path), job.image);
+        if (!job.ok) {
+            PACMAN_LOG_ERROR("Failed to load image: %s", job.path.c_str());
+        }
+        break;
+    case Kind::Sheet: {
+        // Image and JSON resolve separately: a mod may replace either one.
+        sf::Image sheet;
+        std::string json;
+        if (!decodeImage(AssetPack::resolve(mPack, job.path), sheet)) {
+            PACMAN_LOG_ERROR("Failed to load atlas image: %s", job.path.c_str());
+        } else if (!readText(AssetPack::resolve(mPack, job.jsonPath), json)) {
+            PACMAN_LOG_ERROR("Failed to open atlas json: %s", job.jsonPath.c_str());
+        } else {
+            job.ok = SpriteAtlas::readSheet(sheet, json, job.path, job.frames);
+        }
+        break;
+    }
+    case Kind::Sound:
+        job.ok = decodeSound(mPack, job.path, job.sound);
+        break;
+    }
+    PACMAN_LOG_DEBUG("[Assets] Decoded %s in %.1f ms", job.path.c_str(),
+                     std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+}
+
+void AssetLoader::deliver(Job& job) {
+    job.delivered = true;
+    for (const auto& callback : job.callbacks) {
+        callback(job);
+        ++mDelivered;
+    }
+    job.callbacks.clear();
+}
+
+bool AssetLoader::poll() {
+    std::vector<Job*> finished;
+    {
+        std::lock_guard<std::mutex> lock(mFinishedMutex);
+        finished.swap(mFinished);
+    }
+    for (Job* job : finished) {
+        deliver(*job);
+    }
+    return mDelivered == mRequested;
+}
+
+void AssetLoader::finish() {
+    mPool.wait();
+    poll();
+}
+
+float AssetLoader::progress() const {
+    return mRequested == 0 ? 1.f : static_cast<float>(mDelivered) / static_cast<float>(mRequested);
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "AssetPack.h"
+#include "SpriteAtlas.h"
+#include "WorkStealingPool.h"
+
+#include <SFML/Config.hpp>
+#include <SFML/Graphics/Image.hpp>
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Decodes images, sprite sheets and sounds on a worker pool. Finished decodes are handed back
+// by poll() on the calling (main) thread, which is where textures and sound buffers get created:
+// callbacks receive the decoded data, or nullptr when decoding failed. Requests for a path that
+// is already queued or decoded share that decode. Paths go through AssetPack::resolve(): mod
+// files first, then the pack (decoded straight from its mapped bytes), then loose files.
+class AssetLoader {
+public:
+    struct SoundSamples {
+        std::vector<sf::Int16> samples;
+        unsigned channelCount = 0;
+        unsigned sampleRate = 0;
+    };
+
+    using ImageReady = std::function<void(const sf::Image*)>;
+    using SheetReady = std::function<void(const std::vector<SpriteAtlas::Frame>*)>;
+    using SoundReady = std::function<void(const SoundSamples*)>;
+
+    // `pack` may be null or closed (loose files only) and must outlive the loader. A thread count of 0
+    // uses std::thread::hardware_concurrency().
+    explicit AssetLoader(const AssetPack* pack, unsigned threadCount = 0);
+    // Waits for decodes still running; their callbacks are dropped.
+    ~AssetLoader();
+
+    AssetLoader(const AssetLoader&) = delete;
+    AssetLoader& operator=(const AssetLoader&) = delete;
+
+    void loadImage(const std::string& path, ImageReady onReady);
+    void loadSpriteSheet(const std::string& imagePath, const std::string& jsonPath, SheetReady onReady);
+    void loadSound(const std::string& path, SoundReady onReady);
+
+    // Runs the callbacks of every decode finished since the last call. True once every request
+    // so far has been delivered.
+    bool poll();
+    // Blocks until every request has been decoded and delivered.
+    void finish();
+
+    // Requests delivered so far out of all made, for a progress bar.
+    float progress() const;
+
+private:
+    enum class Kind {
+        Image,
+        Sheet,
+        Sound,
+    };
+
+    struct Job {
+        Kind kind = Kind::Image;
+        std::string path;
+        std::string jsonPath;
+        // Written by the decoding worker, read on the main thread only after it is handed back.
+        bool ok = false;
+        sf::Image image;
+        std::vector<SpriteAtlas::Frame> frames;
+        SoundSamples sound;
+        // Main thread only.
+        bool delivered = false;
+        std::vector<std::function<void(const Job&)>> callbacks;
+    };
+
+    void request(Kind kind, const std::string& path, const std::string& jsonPath, std::function<void(const Job&)> callback);
+    void decode(Job& job) const;
+    void deliver(Job& job);
+
+    const AssetPack* mPack = nullptr;
+    std::unordered_map<std::string, std::unique_ptr<Job>> mJobs;
+    std::size_t mRequested = 0;
+    std::size_t mDelivered = 0;
+
+    std::mutex mFinishedMutex;
+    std::vector<Job*> mFinished;
+
+    // Declared last: destroyed first, so no worker outlives the jobs it writes to.
+    WorkStealingPool mPool;
+};
@@ -0,0 +1,270 @@
+#include "AssetPack.h"
+
+#include "Log.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+constexpr char Magic[4] = {'P', 'M', 'P', 'K'};
+constexpr std::uint32_t Version = 1;
+constexpr std::size_t HeaderSize = 12;
+constexpr std::size_t IndexEntrySize = 24;
+constexpr std::size_t DataAlignment = 16;
+
+std::uint64_t readLE(const unsigned char* p, std::size_t bytes) {
+    std::uint64_t v = 0;
+    for (std::size_t i = 0; i < bytes; ++i) {
+        v |= static_cast<std::uint64_t>(p[i]) << (8 * i);
+    }
+    return v;
+}
+
+void writeLE(std::vector<unsigned char>& out, std::uint64_t v, std::size_t bytes) {
+    for (std::size_t i = 0; i < bytes; ++i) {
+        out.push_back(static_cast<unsigned char>(v >> (8 * i)));
+    }
+}
+
+std::size_t alignUp(std::size_t v) {
+    return (v + DataAlignment - 1) / DataAlignment * DataAlignment;
+}
+
+// Maps the whole file read-only; null on failure, with `missing` set when there is no such file.
+const unsigned char* mapFile(const std::string& path, std::size_t& size, bool& missing) {
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        const DWORD error = GetLastError();
+        missing = error == ERROR_FILE_NOT_FOUND || error == ERROR_PATH_NOT_FOUND;
+        return nullptr;
+    }
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+        CloseHandle(file);
+        return nullptr;
+    }
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (mapping == nullptr) {
+        return nullptr;
+    }
+    // The view keeps the mapping alive once its handle is closed.
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    size = static_cast<std::size_t>(fileSize.QuadPart);
+    return static_cast<const unsigned char*>(view);
+#else
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        missing = errno == ENOENT;
+        return nullptr;
+    }
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || st.st_size == 0) {
+        ::close(fd);
+        return nullptr;
+    }
+    size = static_cast<std::size_t>(st.st_size);
+    void* view = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    // The mapping outlives the descriptor.
+    ::close(fd);
+    return view == MAP_FAILED ? nullptr : static_cast<const unsigned char*>(view);
+#endif
+}
+
+void unmapFile(const unsigned char* base, std::size_t size) {
+#ifdef _WIN32
+    (void)size;
+    UnmapViewOfFile(base);
+#else
+    ::munmap(const_cast<unsigned char*>(base), size);
+#endif
+}
+}
+
+AssetPack::~AssetPack() {
+    close();
+}
+
+bool AssetPack::open(const std::string& path) {
+    close();
+
+    std::size_t size = 0;
+    bool missing = false;
+    const unsigned char* base = mapFile(path, size, missing);
+    if (base == nullptr) {
+        // No pack is a normal setup (loose files); the caller decides whether that is an error.
+        if (!missing) {
+            PACMAN_LOG_ERROR("Failed to map asset pack: %s", path.c_str());
+        }
+        return false;
+    }
+    mBase = base;
+    mSize = size;
+
+    if (mSize < HeaderSize || std::memcmp(mBase, Magic, sizeof(Magic)) != 0
+        || readLE(mBase + 4, 4) != Version) {
+        PACMAN_LOG_ERROR("Not a version %u asset pack: %s", static_cast<unsigned>(Version), path.c_str());
+        close();
+        return false;
+    }
+
+    const std::uint64_t count = readLE(mBase + 8, 4);
+    if (count > (mSize - HeaderSize) / IndexEntrySize) {
+        PACMAN_LOG_ERROR("Asset pack index is truncated: %s", path.c_str());
+        close();
+        return false;
+    }
+
+    mEntries.reserve(static_cast<std::size_t>(count));
+    for (std::uint64_t i = 0; i < count; ++i) {
+        const unsigned char* e = mBase + HeaderSize + i * IndexEntrySize;
+        const std::uint64_t dataOffset = readLE(e, 8);
+        const std::uint64_t dataSize = readLE(e + 8, 8);
+        const std::uint64_t nameOffset = readLE(e + 16, 4);
+        const std::uint64_t nameSize = readLE(e + 20, 4);
+        if (dataOffset > mSize || dataSize > mSize - dataOffset || nameOffset > mSize || nameSize > mSize - nameOffset) {
+            PACMAN_LOG_ERROR("Asset pack entry %llu lies outside the file: %s", static_cast<unsigned long long>(i), path.c_str());
+            close();
+            return false;
+        }
+
+        Entry entry;
+        entry.name = std::string_view(reinterpret_cast<const char*>(mBase + nameOffset), static_cast<std::size_t>(nameSize));
+        entry.data.bytes = mBase + dataOffset;
+        entry.data.size = static_cast<std::size_t>(dataSize);
+        if (!mEntries.empty() && !(mEntries.back().name < entry.name)) {
+            PACMAN_LOG_ERROR("Asset pack index is not sorted: %s", path.c_str());
+            close();
+            return false;
+        }
+        mEntries.push_back(entry);
+    }
+    return true;
+}
+
+void AssetPack::close() {
+    if (mBase != nullptr) {
+        unmapFile(mBase, mSize);
+    }
+    mBase = nullptr;
+    mSize = 0;
+    mEntries.clear();
+}
+
+AssetPack::Data AssetPack::find(std::string_view name) const {
+    const auto it = std::lower_bound(mEntries.begin(), mEntries.end(), name,
+                                     [](const Entry& e, std::string_view n) { return e.name < n; });
+    if (it == mEntries.end() || it->name != name) {
+        return {};
+    }
+    return it->data;
+}
+
+AssetPack::Source AssetPack::resolve(const AssetPack* pack, const std::string& name) {
+    std::error_code ec;
+    const std::filesystem::path mod = std::filesystem::path(ModDirectory) / name;
+    if (std::filesystem::is_regular_file(mod, ec)) {
+        PACMAN_LOG_INFO("[Assets] %s overridden by %s", name.c_str(), mod.generic_string().c_str());
+        return {Data{}, mod.string()};
+    }
+    return {pack != nullptr ? pack->find(name) : Data{}, name};
+}
+
+bool AssetPack::build(const std::string& directory, const std::string& outputPath) {
+    namespace fs = std::filesystem;
+
+    std::error_code ec;
+    fs::path root = fs::path(directory).lexically_normal();
+    if (!root.has_filename()) {
+        root = root.parent_path(); // "assets/" -> "assets"
+    }
+    std::vector<std::pair<std::string, fs::path>> files;
+    for (fs::recursive_directory_iterator it(root, ec), end; !ec && it != end; it.increment(ec)) {
+        if (it->is_regular_file(ec)) {
+            // Named like the loose files the game would otherwise open: "assets/maps/level1.txt".
+            files.emplace_back((root.filename() / it->path().lexically_relative(root)).generic_string(), it->path());
+        }
+    }
+    if (ec) {
+        PACMAN_LOG_ERROR("Failed to list %s: %s", directory.c_str(), ec.message().c_str());
+        return false;
+    }
+    std::sort(files.begin(), files.end());
+
+    std::vector<std::vector<char>> contents;
+    contents.reserve(files.size());
+    for (const auto& file : files) {
+        std::ifstream in(file.second, std::ios::binary);
+        if (!in) {
+            PACMAN_LOG_ERROR("Failed to read %s", file.second.string().c_str());
+            return false;
+        }
+        contents.emplace_back(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+
+    std::size_t namesSize = 0;
+    for (const auto& file : files) {
+        namesSize += file.first.size();
+    }
+
+    std::vector<unsigned char> header;
+    header.insert(header.end(), std::begin(Magic), std::end(Magic));
+    writeLE(header, Version, 4);
+    writeLE(header, files.size(), 4);
+
+    std::size_t nameOffset = HeaderSize + files.size() * IndexEntrySize;
+    std::size_t dataOffset = alignUp(nameOffset + namesSize);
+    std::vector<std::size_t> dataOffsets;
+    for (std::size_t i = 0; i < files.size(); ++i) {
+        writeLE(header, dataOffset, 8);
+        writeLE(header, contents[i].size(), 8);
+        writeLE(header, nameOffset, 4);
+        writeLE(header, files[i].first.size(), 4);
+        dataOffsets.push_back(dataOffset);
+        nameOffset += files[i].first.size();
+        dataOffset = alignUp(dataOffset + contents[i].size());
+    }
+    for (const auto& file : files) {
+        header.insert(header.end(), file.first.begin(), file.first.end());
+    }
+
+    std::ofstream out(outputPath, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        PACMAN_LOG_ERROR("Failed to open asset pack for writing: %s", outputPath.c_str());
+        return false;
+    }
+    out.write(reinterpret_cast<const char*>(header.data()), static_cast<std::streamsize>(header.size()));
+    std::size_t written = header.size();
+    const char padding[DataAlignment] = {};
+    for (std::size_t i = 0; i < files.size(); ++i) {
+        out.write(padding, static_cast<std::streamsize>(dataOffsets[i] - written));
+        out.write(contents[i].data(), static_cast<std::streamsize>(contents[i].size()));
+        written = dataOffsets[i] + contents[i].size();
+    }
+    if (!out) {
+        PACMAN_LOG_ERROR("Failed to write asset pack: %s", outputPath.c_str());
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Read-only asset bundle built by pacman_pack. The whole file is memory-mapped, so opening it
+// is one open call, lookups are a binary search over the index, and the returned bytes point
+// straight into the mapping (hand them to loadFromMemory()). Processes mapping the same pack
+// share its page-cache pages.
+//
+// Layout, little-endian: "PMPK", u32 version, u32 entry count, then per entry u64 data offset,
+// u64 data size, u32 name offset, u32 name size (sorted by name), then the names, then the
+// data blobs, each 16-byte aligned.
+class AssetPack {
+public:
+    struct Data {
+        const void* bytes = nullptr;
+        std::size_t size = 0;
+
+        explicit operator bool() const { return bytes != nullptr; }
+        std::string_view text() const { return {static_cast<const char*>(bytes), size}; }
+    };
+
+    // Where an asset is read from; see resolve().
+    struct Source {
+        Data packed;      // the pack entry, when the asset comes from the pack
+        std::string path; // otherwise the file to read
+    };
+
+    // Files under this directory override assets of the same name, packed or loose:
+    // "mods/assets/maps/level1.txt" replaces "assets/maps/level1.txt" without rebuilding the pack.
+    static constexpr const char* ModDirectory = "mods";
+
+    AssetPack() = default;
+    ~AssetPack();
+
+    AssetPack(const AssetPack&) = delete;
+    AssetPack& operator=(const AssetPack&) = delete;
+
+    // False when the file is missing (silently) or is not a valid pack (logged as an error).
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return mBase != nullptr; }
+
+    // Entries are named by their path as loose files, e.g. "assets/maps/level1.txt". Empty
+    // Data when the pack has no such entry. Valid until close().
+    Data find(std::string_view name) const;
+    std::size_t entryCount() const { return mEntries.size(); }
+
+    // A mod file wins, then the entry in `pack` (which may be null or closed), then the loose
+    // file `name` itself.
+    static Source resolve(const AssetPack* pack, const std::string& name);
+
+    // Packs every regular file under `directory`, named by its path relative to the
+    // directory's parent, into `outputPath`.
+    static bool build(const std::string& directory, const std::string& outputPath);
+
+private:
+    struct Entry {
+        std::string_view name;
+        Data data;
+    };
+
+    const unsigned char* mBase = nullptr;
+    std::size_t mSize = 0;
+    std::vector<Entry> mEntries; // sorted by name
+};
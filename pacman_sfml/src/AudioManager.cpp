@@ -1,36 +1,80 @@
 #include "AudioManager.h"
 
-#include <iostream>
+#include "Log.h"
 
 bool AudioManager::loadSound(const std::string& id, const std::string& path) {
-    sf::SoundBuffer buf;
-    if (!buf.loadFromFile(path)) {
-        std::cerr << "Failed to load sound: " << path << "\n";
-        return false;
+    auto it = mBuffers.find(path);
+    if (it == mBuffers.end()) {
+        it = mBuffers.try_emplace(path).first;
+        if (!it->second.loadFromFile(path)) {
+            mBuffers.erase(it);
+            PACMAN_LOG_ERROR("Failed to load sound: %s", path.c_str());
+            return false;
+        }
     }
+    addSound(id, it->second);
+    return true;
+}
 
-    mBuffers[id] = std::move(buf);
-    sf::Sound snd;
-    snd.setBuffer(mBuffers[id]);
-    snd.setVolume(mVolume);
-    mSounds[id] = std::move(snd);
+bool AudioManager::loadSoundFromSamples(const std::string& id, const std::string& path, const sf::Int16* samples,
+                                        std::uint64_t sampleCount, unsigned channelCount, unsigned sampleRate) {
+    auto it = mBuffers.find(path);
+    if (it == mBuffers.end()) {
+        it = mBuffers.try_emplace(path).first;
+        if (!it->second.loadFromSamples(samples, sampleCount, channelCount, sampleRate)) {
+            mBuffers.erase(it);
+            PACMAN_LOG_ERROR("Failed to create sound buffer: %s (%s)", id.c_str(), path.c_str());
+            return false;
+        }
+    }
+    addSound(id, it->second);
     return true;
 }
 
-void AudioManager::playSound(const std::string& id) {
-    auto it = mSounds.find(id);
-    if (it == mSounds.end()) {
+void AudioManager::addSound(const std::string& id, const sf::SoundBuffer& buffer) {
+    sf::Sound& snd = mSounds[id];
+    snd.setBuffer(buffer);
+    snd.setVolume(mVolume);
+    if (mHandles.find(id) == mHandles.end()) {
+        mHandles[id] = static_cast<SoundHandle>(mSoundsByHandle.size());
+        mSoundsByHandle.push_back(&mSounds[id]);
+    }
+}
+
+SoundHandle AudioManager::findSound(const std::string& id) const {
+    auto it = mHandles.find(id);
+    return it == mHandles.end() ? InvalidSound : it->second;
+}
+
+void AudioManager::playSound(SoundHandle sound) {
+    if (sound >= mSoundsByHandle.size()) {
         return;
     }
 
     // Restart sound to feel responsive.
-    it->second.stop();
-    it->second.play();
+    sf::Sound& s = *mSoundsByHandle[sound];
+    s.stop();
+    s.play();
+}
+
+void AudioManager::playSound(const std::string& id) {
+    playSound(findSound(id));
 }
 
 bool AudioManager::playMusic(const std::string& path, bool loop) {
     if (!mMusic.openFromFile(path)) {
-        std::cerr << "Failed to open music: " << path << "\n";
+        PACMAN_LOG_ERROR("Failed to open music: %s", path.c_str());
+        return false;
+    }
+    mMusic.setLoop(loop);
+    mMusic.setVolume(mVolume);
+    mMusic.play();
+    return true;
+}
+
+bool AudioManager::playMusicFromMemory(const void* data, std::size_t size, bool loop) {
+    if (!mMusic.openFromMemory(data, size)) {
+        PACMAN_LOG_ERROR("Failed to open music from memory");
         return false;
     }
     mMusic.setLoop(loop);
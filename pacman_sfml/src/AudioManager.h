@@ -3,23 +3,49 @@
 #include <SFML/Audio/Music.hpp>
 #include <SFML/Audio/Sound.hpp>
 #include <SFML/Audio/SoundBuffer.hpp>
+#include <SFML/Config.hpp>
 
+#include <cstddef>
+#include <cstdint>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
+// Index of a loaded sound; resolve it once after loading so playing skips the name lookup.
+using SoundHandle = std::uint16_t;
+constexpr SoundHandle InvalidSound = 0xFFFF;
+
+// Sound buffers are keyed by source path: ids loaded from the same file share one buffer,
+// each with its own sf::Sound so they still restart independently.
 class AudioManager {
 public:
     bool loadSound(const std::string& id, const std::string& path);
+    // Same, from samples already decoded from `path` (on a loader thread); creating the buffer
+    // stays here, and a buffer already made for `path` is reused instead.
+    bool loadSoundFromSamples(const std::string& id, const std::string& path, const sf::Int16* samples,
+                              std::uint64_t sampleCount, unsigned channelCount, unsigned sampleRate);
+    // InvalidSound when no sound was loaded under `id`.
+    SoundHandle findSound(const std::string& id) const;
+
+    void playSound(SoundHandle sound);
     void playSound(const std::string& id);
 
     bool playMusic(const std::string& path, bool loop = true);
+    // Streams from the bytes (an AssetPack entry), which must outlive playback.
+    bool playMusicFromMemory(const void* data, std::size_t size, bool loop = true);
     void stopMusic();
 
     void setMasterVolume(float v01);
 
 private:
+    void addSound(const std::string& id, const sf::SoundBuffer& buffer);
+
+    // By source path. Map nodes never move, so the sounds' buffer pointers stay valid.
     std::unordered_map<std::string, sf::SoundBuffer> mBuffers;
     std::unordered_map<std::string, sf::Sound> mSounds;
+    // Map nodes never move, so these stay valid as more sounds are loaded.
+    std::vector<sf::Sound*> mSoundsByHandle;
+    std::unordered_map<std::string, SoundHandle> mHandles;
 
     sf::Music mMusic;
     float mVolume = 100.f;
@@ -0,0 +1,38 @@
+#include "Autopilot.h"
+
+#include "Direction.h"
+#include "Random.h"
+#include "Simulation.h"
+
+void Autopilot::reset(std::uint32_t seed) {
+    mRng.seed(seed);
+    mLastTile = {-1, -1};
+}
+
+Direction Autopilot::decide(const Simulation& sim) {
+    const Map& map = sim.map();
+    const Player& player = sim.player();
+    const TileCoord tile = player.currentTile(map, sim.tileSize());
+
+    // Only re-decide when entering a new tile or when blocked.
+    if (tile == mLastTile && player.direction() != Direction::None) {
+        return Direction::None;
+    }
+    mLastTile = tile;
+
+    Direction options[4];
+    int count = 0;
+    const Direction rev = opposite(player.direction());
+    for (Direction d : {Direction::Up, Direction::Down, Direction::Left, Direction::Right}) {
+        const TileCoord to = map.nextTile(tile, d);
+        if (d != rev && map.isWalkable(to.x, to.y)) {
+            options[count++] = d;
+        }
+    }
+
+    if (count == 0) {
+        return rev;
+    }
+
+    return options[pickIndex(mRng, static_cast<std::size_t>(count))];
+}
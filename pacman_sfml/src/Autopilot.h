@@ -0,0 +1,24 @@
+#pragma once
+
+#include "Types.h"
+
+#include <cstdint>
+#include <random>
+
+class Simulation;
+
+// Input source for headless runs: a random walker that picks a new corridor at
+// every tile it enters, avoiding reversals unless it is stuck in a dead end.
+class Autopilot {
+public:
+    explicit Autopilot(std::uint32_t seed = 0) : mRng(seed) {}
+
+    void reset(std::uint32_t seed);
+
+    // Direction to request this tick, or Direction::None to keep the current one.
+    Direction decide(const Simulation& sim);
+
+private:
+    std::mt19937 mRng;
+    TileCoord mLastTile{-1, -1};
+};
@@ -1,6 +1,8 @@
 #include "BitmapFont.h"
 
-#include <SFML/Graphics/VertexArray.hpp>
+#include "Log.h"
+
+#include <SFML/Graphics/Image.hpp>
 
 #include <array>
 
@@ -137,6 +139,45 @@ unsigned char BitmapFont::glyphRowBits(unsigned char c, int row) {
     return glyphFor(c)[static_cast<std::size_t>(row)];
 }
 
+int BitmapFont::sheetIndex(unsigned char c) {
+    c = toUpperAscii(c);
+    if (c < FirstChar || c >= FirstChar + CharCount) {
+        c = '?';
+    }
+    return c - FirstChar;
+}
+
+bool BitmapFont::bake() {
+    constexpr unsigned CellW = GlyphW + 1;
+    constexpr unsigned CellH = GlyphH + 1;
+    constexpr unsigned Rows = (CharCount + SheetColumns - 1) / SheetColumns;
+
+    sf::Image sheet;
+    sheet.create(SheetColumns * CellW, Rows * CellH, sf::Color::Transparent);
+
+    for (int i = 0; i < CharCount; ++i) {
+        const unsigned char c = static_cast<unsigned char>(FirstChar + i);
+        const unsigned cellX = static_cast<unsigned>(i % SheetColumns) * CellW;
+        const unsigned cellY = static_cast<unsigned>(i / SheetColumns) * CellH;
+        for (int row = 0; row < GlyphH; ++row) {
+            const unsigned char bits = glyphRowBits(c, row);
+            for (int col = 0; col < GlyphW; ++col) {
+                const int bit = (GlyphW - 1 - col);
+                if (((bits >> bit) & 1u) != 0u) {
+                    sheet.setPixel(cellX + static_cast<unsigned>(col), cellY + static_cast<unsigned>(row), sf::Color::White);
+                }
+            }
+        }
+    }
+
+    if (!mTexture.loadFromImage(sheet)) {
+        PACMAN_LOG_ERROR("Failed to create bitmap font texture");
+        return false;
+    }
+    mTexture.setSmooth(false);
+    return true;
+}
+
 sf::Vector2f BitmapFont::measure(std::string_view text, int scale) const {
     if (scale < 1) scale = 1;
     const float adv = static_cast<float>((GlyphW + Spacing) * scale);
@@ -150,37 +191,68 @@ void BitmapFont::draw(sf::RenderTarget& target,
                       sf::Vector2f pos,
                       int scale,
                       sf::Color color) const {
-    if (scale < 1) scale = 1;
-
     sf::VertexArray quads(sf::Quads);
+    append(quads, text, pos, scale, color);
+    target.draw(quads, sf::RenderStates(&mTexture));
+}
+
+void BitmapFont::append(sf::VertexArray& quads,
+                        std::string_view text,
+                        sf::Vector2f pos,
+                        int scale,
+                        sf::Color color) const {
+    if (scale < 1) scale = 1;
 
-    const float pixel = static_cast<float>(scale);
     const float adv = static_cast<float>((GlyphW + Spacing) * scale);
+    const float w = static_cast<float>(GlyphW * scale);
+    const float h = static_cast<float>(GlyphH * scale);
 
     float x = pos.x;
-    const float y0 = pos.y;
+    const float y = pos.y;
 
     for (unsigned char c : text) {
-        for (int row = 0; row < GlyphH; ++row) {
-            const unsigned char bits = glyphRowBits(c, row);
-            for (int col = 0; col < GlyphW; ++col) {
-                const int bit = (GlyphW - 1 - col);
-                if (((bits >> bit) & 1u) == 0u) {
-                    continue;
-                }
-
-                const float px = x + static_cast<float>(col) * pixel;
-                const float py = y0 + static_cast<float>(row) * pixel;
+        if (c != ' ') {
+            const int index = sheetIndex(c);
+            const float u0 = static_cast<float>((index % SheetColumns) * (GlyphW + 1));
+            const float v0 = static_cast<float>((index / SheetColumns) * (GlyphH + 1));
+            const float u1 = u0 + static_cast<float>(GlyphW);
+            const float v1 = v0 + static_cast<float>(GlyphH);
 
-                quads.append(sf::Vertex({px, py}, color));
-                quads.append(sf::Vertex({px + pixel, py}, color));
-                quads.append(sf::Vertex({px + pixel, py + pixel}, color));
-                quads.append(sf::Vertex({px, py + pixel}, color));
-            }
+            quads.append(sf::Vertex({x, y}, color, {u0, v0}));
+            quads.append(sf::Vertex({x + w, y}, color, {u1, v0}));
+            quads.append(sf::Vertex({x + w, y + h}, color, {u1, v1}));
+            quads.append(sf::Vertex({x, y + h}, color, {u0, v1}));
         }
 
         x += adv;
     }
+}
+
+void TextMesh::set(const BitmapFont& font, std::string_view text, sf::Vector2f pos, int scale, sf::Color color) {
+    if (mFont == &font && mScale == scale && mPos == pos && mColor == color && std::string_view(mText) == text) {
+        return;
+    }
+
+    mFont = &font;
+    mText.assign(text.data(), text.size());
+    mPos = pos;
+    mScale = scale;
+    mColor = color;
 
-    target.draw(quads);
+    mQuads.clear();
+    font.append(mQuads, text, pos, scale, color);
+}
+
+void TextMesh::clear() {
+    mFont = nullptr;
+    mText.clear();
+    mQuads.clear();
+}
+
+void TextMesh::draw(sf::RenderTarget& target, sf::RenderStates states) const {
+    if (mFont == nullptr || mQuads.getVertexCount() == 0) {
+        return;
+    }
+    states.texture = &mFont->texture();
+    target.draw(mQuads, states);
 }
@@ -1,27 +1,73 @@
 #pragma once
 
 #include <SFML/Graphics/Color.hpp>
+#include <SFML/Graphics/Drawable.hpp>
 #include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/Graphics/Texture.hpp>
+#include <SFML/Graphics/VertexArray.hpp>
 #include <SFML/System/Vector2.hpp>
 
+#include <string>
 #include <string_view>
 
+// All-caps 5x7 bitmap font. bake() rasterises every glyph once into a small texture; after
+// that each character is a single textured quad.
 class BitmapFont {
 public:
+    // Needs a live GL context (create the window first).
+    bool bake();
+
+    const sf::Texture& texture() const { return mTexture; }
+
     sf::Vector2f measure(std::string_view text, int scale = 1) const;
 
-    // Draws an all-caps 5x7 bitmap font.
+    // One-off text; builds a temporary vertex array. Use TextMesh for text drawn every frame.
     void draw(sf::RenderTarget& target,
               std::string_view text,
               sf::Vector2f pos,
               int scale,
               sf::Color color) const;
 
+    // Appends one quad per visible character to a caller-owned sf::Quads array, for text that
+    // is laid out once and drawn many times. Draw the array with texture().
+    void append(sf::VertexArray& quads,
+                std::string_view text,
+                sf::Vector2f pos,
+                int scale,
+                sf::Color color) const;
+
 private:
     static constexpr int GlyphW = 5;
     static constexpr int GlyphH = 7;
     static constexpr int Spacing = 1;
 
+    // Printable ASCII, laid out in a grid of (GlyphW + 1) x (GlyphH + 1) cells.
+    static constexpr int FirstChar = 32;
+    static constexpr int CharCount = 95;
+    static constexpr int SheetColumns = 16;
+
     static unsigned char toUpperAscii(unsigned char c);
     static unsigned char glyphRowBits(unsigned char c, int row);
+    static int sheetIndex(unsigned char c);
+
+    sf::Texture mTexture;
+};
+
+// Retained text: keeps its vertices between frames and lays them out again only when the
+// text, position, scale or colour passed to set() actually differ.
+class TextMesh : public sf::Drawable {
+public:
+    void set(const BitmapFont& font, std::string_view text, sf::Vector2f pos, int scale, sf::Color color);
+    void clear();
+    std::size_t vertexCount() const { return mQuads.getVertexCount(); }
+
+private:
+    void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+
+    const BitmapFont* mFont = nullptr;
+    std::string mText;
+    sf::Vector2f mPos{0.f, 0.f};
+    int mScale = 0;
+    sf::Color mColor;
+    sf::VertexArray mQuads{sf::Quads};
 };
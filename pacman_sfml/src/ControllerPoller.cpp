@@ -0,0 +1,86 @@
+#include "ControllerPoller.h"
+
+#include "Log.h"
+#include "Profiler.h"
+
+#include <SFML/Window/Joystick.hpp>
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+
+namespace {
+constexpr auto PollInterval = std::chrono::milliseconds(1);
+constexpr float DeadZone = 40.f;
+
+// D-pad as POV is not standardized; use axes for a basic default.
+Direction stickDirection(float x, float y) {
+    if (std::abs(x) > std::abs(y)) {
+        if (x > DeadZone) return Direction::Right;
+        if (x < -DeadZone) return Direction::Left;
+    } else {
+        if (y > DeadZone) return Direction::Down;
+        if (y < -DeadZone) return Direction::Up;
+    }
+    return Direction::None;
+}
+}
+
+ControllerPoller::~ControllerPoller() {
+    stop();
+}
+
+void ControllerPoller::start() {
+    if (mThread.joinable()) {
+        return;
+    }
+    mStopping.store(false);
+    mThread = std::thread([this] { run(); });
+}
+
+void ControllerPoller::stop() {
+    if (!mThread.joinable()) {
+        return;
+    }
+    mStopping.store(true);
+    mThread.join();
+}
+
+void ControllerPoller::run() {
+    Profiler::setThreadName("controller");
+    Log::setThreadName("controller");
+    Direction last = Direction::None;
+    std::uint64_t lastSentTick = 0;
+
+    while (!mStopping.load()) {
+        std::this_thread::sleep_for(PollInterval);
+
+        if (!mEnabled.load()) {
+            last = Direction::None;
+            continue;
+        }
+
+        Direction d = Direction::None;
+        {
+            std::lock_guard<std::mutex> lock(mJoystickMutex);
+            // No window events on this thread, so refresh the joystick state by hand.
+            sf::Joystick::update();
+            if (sf::Joystick::isConnected(0)) {
+                d = stickDirection(sf::Joystick::getAxisPosition(0, sf::Joystick::X),
+                                   sf::Joystick::getAxisPosition(0, sf::Joystick::Y));
+            }
+        }
+        const auto now = std::chrono::steady_clock::now();
+
+        // Send changes at once, and re-send a held stick once per simulated tick: a death or a
+        // new game resets the requested direction, and the held stick has to win it back.
+        const std::uint64_t tick = mSim.ticksRun();
+        if (d != Direction::None && (d != last || tick != lastSentTick)) {
+            if (!mSim.pushInput(InputSource::Controller, d, now, d == last)) {
+                continue; // queue full; retry on the next sample
+            }
+            lastSentTick = tick;
+        }
+        last = d;
+    }
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "SimulationThread.h"
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+// Samples joystick 0 on its own thread at about 1 kHz and queues every change of stick
+// direction, timestamped, on the simulation's controller input queue; a held stick is re-sent
+// once per simulated tick. Input latency then no longer depends on when the render loop gets
+// around to polling.
+//
+// SFML also refreshes joystick state inside Window::pollEvent() and Window::create(), so the
+// owner must hold `joystickMutex` around those calls.
+class ControllerPoller {
+public:
+    ControllerPoller(SimulationThread& sim, std::mutex& joystickMutex) : mSim(sim), mJoystickMutex(joystickMutex) {}
+    ~ControllerPoller();
+
+    ControllerPoller(const ControllerPoller&) = delete;
+    ControllerPoller& operator=(const ControllerPoller&) = delete;
+
+    void start();
+    void stop();
+
+    // Only enabled pollers queue input.
+    void setEnabled(bool enabled) { mEnabled.store(enabled); }
+
+private:
+    void run();
+
+    SimulationThread& mSim;
+    std::mutex& mJoystickMutex;
+    std::thread mThread;
+    std::atomic<bool> mStopping{false};
+    std::atomic<bool> mEnabled{false};
+};
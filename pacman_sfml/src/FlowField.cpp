@@ -0,0 +1,138 @@
+#include "FlowField.h"
+
+#include "Map.h"
+
+namespace {
+constexpr Direction Moves[4] = {Direction::Up, Direction::Left, Direction::Down, Direction::Right};
+}
+
+void ReverseGraph::build(const Map& map) {
+    width = map.width();
+    height = map.height();
+
+    const std::size_t tileCount = static_cast<std::size_t>(width * height);
+    offsets.assign(tileCount + 1, 0);
+    sources.clear();
+
+    // Count incoming edges, then fill (two passes keep the CSR arrays contiguous).
+    auto forEachEdge = [&](auto&& fn) {
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x) {
+                if (!map.isWalkable(x, y)) {
+                    continue;
+                }
+                for (Direction d : Moves) {
+                    const TileCoord to = map.nextTile({x, y}, d);
+                    if (to.x < 0 || to.y < 0 || to.x >= width || to.y >= height || !map.isWalkable(to.x, to.y)) {
+                        continue;
+                    }
+                    fn(y * width + x, to.y * width + to.x);
+                }
+            }
+        }
+    };
+
+    forEachEdge([&](int, int to) { ++offsets[static_cast<std::size_t>(to) + 1]; });
+    for (std::size_t i = 1; i < offsets.size(); ++i) {
+        offsets[i] += offsets[i - 1];
+    }
+
+    sources.resize(static_cast<std::size_t>(offsets.back()));
+    std::vector<std::int32_t> cursor(offsets.begin(), offsets.end() - 1);
+    forEachEdge([&](int from, int to) { sources[static_cast<std::size_t>(cursor[static_cast<std::size_t>(to)]++)] = from; });
+}
+
+void FlowField::build(const ReverseGraph& graph, const Map& map, TileCoord target) {
+    mWidth = graph.width;
+    mHeight = graph.height;
+    mTarget = target;
+
+    const std::size_t tileCount = static_cast<std::size_t>(mWidth * mHeight);
+    mDist.assign(tileCount, -1);
+    mQueue.resize(tileCount);
+
+    if (target.x < 0 || target.y < 0 || target.x >= mWidth || target.y >= mHeight || !map.isWalkable(target.x, target.y)) {
+        return;
+    }
+
+    const std::int32_t start = target.y * mWidth + target.x;
+    mDist[static_cast<std::size_t>(start)] = 0;
+
+    std::size_t head = 0;
+    std::size_t tail = 0;
+    mQueue[tail++] = start;
+
+    while (head < tail) {
+        const std::int32_t cur = mQueue[head++];
+        const std::int32_t next = mDist[static_cast<std::size_t>(cur)] + 1;
+
+        const std::int32_t end = graph.offsets[static_cast<std::size_t>(cur) + 1];
+        for (std::int32_t e = graph.offsets[static_cast<std::size_t>(cur)]; e < end; ++e) {
+            const std::int32_t src = graph.sources[static_cast<std::size_t>(e)];
+            if (mDist[static_cast<std::size_t>(src)] != -1) {
+                continue;
+            }
+            mDist[static_cast<std::size_t>(src)] = next;
+            mQueue[tail++] = src;
+        }
+    }
+}
+
+int FlowField::distance(TileCoord from) const {
+    if (from == mTarget) {
+        return 0;
+    }
+    if (from.x < 0 || from.y < 0 || from.x >= mWidth || from.y >= mHeight) {
+        return -1;
+    }
+    return mDist[static_cast<std::size_t>(from.y * mWidth + from.x)];
+}
+
+void FlowFieldCache::syncLayout(const Map& map) {
+    if (map.layoutRevision() == mLayoutRevision && mGraph.width == map.width() && mGraph.height == map.height()) {
+        return;
+    }
+
+    mLayoutRevision = map.layoutRevision();
+    mGraph.build(map);
+    for (auto& e : mEntries) {
+        e.valid = false;
+        e.used = false;
+    }
+}
+
+void FlowFieldCache::beginTick(const Map& map) {
+    syncLayout(map);
+
+    for (auto& e : mEntries) {
+        if (!e.used) {
+            e.valid = false;
+        }
+        e.used = false;
+    }
+}
+
+const FlowField& FlowFieldCache::field(const Map& map, TileCoord target) {
+    syncLayout(map);
+
+    Entry* freeSlot = nullptr;
+    for (auto& e : mEntries) {
+        if (e.valid && e.field.target() == target) {
+            e.used = true;
+            return e.field;
+        }
+        if (!e.valid && !freeSlot) {
+            freeSlot = &e;
+        }
+    }
+
+    if (!freeSlot) {
+        mEntries.emplace_back();
+        freeSlot = &mEntries.back();
+    }
+
+    freeSlot->field.build(mGraph, map, target);
+    freeSlot->valid = true;
+    freeSlot->used = true;
+    return freeSlot->field;
+}
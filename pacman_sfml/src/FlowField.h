@@ -0,0 +1,65 @@
+#pragma once
+
+#include "Types.h"
+
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+class Map;
+
+// Reverse adjacency of a maze in CSR form: for every tile, the tiles that step onto it
+// (warp endpoints included). Built once per layout and shared by all flow fields.
+struct ReverseGraph {
+    void build(const Map& map);
+
+    int width = 0;
+    int height = 0;
+    std::vector<std::int32_t> offsets;
+    std::vector<std::int32_t> sources;
+};
+
+// Distance from every tile to one target, computed by a single reverse BFS.
+class FlowField {
+public:
+    void build(const ReverseGraph& graph, const Map& map, TileCoord target);
+
+    TileCoord target() const { return mTarget; }
+
+    // Same contract as a forward BFS from `from` to the target: 0 when from == target,
+    // -1 when either tile is not walkable or no path exists.
+    int distance(TileCoord from) const;
+
+private:
+    int mWidth = 0;
+    int mHeight = 0;
+    TileCoord mTarget{0, 0};
+    std::vector<std::int32_t> mDist;
+    std::vector<std::int32_t> mQueue;
+};
+
+// Per-tick cache of flow fields keyed by target tile. Ghosts chasing the same tile share one
+// field, so BFS work scales with distinct targets instead of ghosts x candidate directions.
+class FlowFieldCache {
+public:
+    // Call once per simulation tick. Fields nobody asked for during the previous tick are
+    // released; everything is dropped when the maze layout changed.
+    void beginTick(const Map& map);
+
+    const FlowField& field(const Map& map, TileCoord target);
+
+private:
+    struct Entry {
+        FlowField field;
+        bool valid = false;
+        bool used = false;
+    };
+
+    void syncLayout(const Map& map);
+
+    ReverseGraph mGraph;
+    std::uint32_t mLayoutRevision = 0;
+    // Slots are recycled so steady-state ticks reuse the same distance buffers; a deque keeps
+    // references handed out by field() valid while new slots are added.
+    std::deque<Entry> mEntries;
+};
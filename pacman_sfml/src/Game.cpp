@@ -1,211 +1,399 @@
 #include "Game.h"
 
+#include "AllocationCounter.h"
 #include "Direction.h"
+#include "Log.h"
+#include "Profiler.h"
 
 #include <SFML/Window/Event.hpp>
-#include <SFML/Window/Joystick.hpp>
 
-#include <cmath>
+#include <algorithm>
+#include <chrono>
 #include <filesystem>
 #include <fstream>
-#include <iostream>
+#include <thread>
 
 namespace {
-// Simple relative path resolution - just return the path as-is
-// Assets are expected to be in the current directory's 'assets' subfolder
-std::string tryResolveAsset(const std::string& relative) {
-    // Just return the relative path - assets are copied to the build directory
-    return relative;
-}
-
-float distSq(sf::Vector2f a, sf::Vector2f b) {
-    const float dx = a.x - b.x;
-    const float dy = a.y - b.y;
-    return dx * dx + dy * dy;
-}
+// Built by pacman_pack next to the executable. Entries keep their loose-file names
+// ("assets/..."), which is also where assets are read from when there is no pack.
+const char* const AssetPackPath = "assets.pak";
 
-TileCoord clampToMap(TileCoord t, const Map& map) {
-    if (t.x < 0) t.x = 0;
-    if (t.y < 0) t.y = 0;
-    if (t.x >= map.width()) t.x = map.width() - 1;
-    if (t.y >= map.height()) t.y = map.height() - 1;
-    return t;
-}
+// Nine decodes at startup; more threads than this only add spawn cost.
+constexpr unsigned MaxAssetThreads = 4;
 }
 
 Game::Game()
     : mWindow(sf::VideoMode(960, 720), "Pac-Man (SFML)", sf::Style::Default),
       mRenderer(mWindow) {
-    std::cerr << "[Game] Window and Renderer created" << std::endl;
-    
+    PACMAN_LOG_INFO("[Game] Window and Renderer created");
+    if (mAssetPack.open(AssetPackPath)) {
+        PACMAN_LOG_INFO("[Game] Mapped %s (%zu assets)", AssetPackPath, mAssetPack.entryCount());
+        mSim.setAssetPack(&mAssetPack);
+    } else {
+        PACMAN_LOG_INFO("[Game] No usable %s; loading loose asset files", AssetPackPath);
+    }
+    startAssetLoading();
+
     mWindow.setVerticalSyncEnabled(true);
-    std::cerr << "[Game] VSync enabled" << std::endl;
+    PACMAN_LOG_INFO("[Game] VSync enabled");
 
     std::random_device rd;
-    mRng.seed(rd());
-    std::cerr << "[Game] RNG seeded" << std::endl;
+    mSeed = rd();
+    mSim.seed(mSeed);
+    PACMAN_LOG_INFO("[Game] RNG seeded");
 
     mMainMenu.setTitle("PAC-MAN");
     mMainMenu.setItems({"Start Game", "Options", "Exit"});
-    std::cerr << "[Game] Main menu configured" << std::endl;
+    PACMAN_LOG_INFO("[Game] Main menu configured");
 
     mPauseMenu.setTitle("Paused");
     mPauseMenu.setItems({"Resume", "Quit to Menu"});
-    std::cerr << "[Game] Pause menu configured" << std::endl;
-
-    // Load assets (optional).
-    std::string fontPath = tryResolveAsset("assets/fonts/PressStart2P.ttf");
-    std::cerr << "[Game] Loading font from: " << fontPath << std::endl;
-    mRenderer.loadFont(fontPath);
-    std::cerr << "[Game] Font loaded" << std::endl;
-    
-    std::string atlasPath = tryResolveAsset("assets/sprites/atlas.bmp");
-    std::string atlasJsonPath = tryResolveAsset("assets/sprites/atlas.json");
-    std::cerr << "[Game] Loading atlas from: " << atlasPath << " and " << atlasJsonPath << std::endl;
-    mRenderer.loadAtlas(atlasPath, atlasJsonPath);
-    std::cerr << "[Game] Atlas loaded" << std::endl;
-
-    std::string backgroundPath = tryResolveAsset("assets/fonts/BackG.jpg");
-    std::cerr << "[Game] Loading background from: " << backgroundPath << std::endl;
-    mRenderer.loadBackground(backgroundPath);
-
-    std::cerr << "[Game] Loading map sprites..." << std::endl;
-    mRenderer.loadMapSprites(tryResolveAsset("assets/sprites/tile.png"),
-                              tryResolveAsset("assets/sprites/minicoin.png"),
-                              tryResolveAsset("assets/sprites/bigcoin.png"));
-    mRenderer.loadHeartTexture(tryResolveAsset("assets/sprites/heart.png"));
+    PACMAN_LOG_INFO("[Game] Pause menu configured");
+
+    // The menu frame only needs the font and the maze, loaded here while the loader threads
+    // decode everything else; the main loop uploads the rest as it arrives.
+    const std::string fontPath = "assets/fonts/PressStart2P.ttf";
+    PACMAN_LOG_INFO("[Game] Loading font from: %s", fontPath.c_str());
+    const AssetPack::Source font = AssetPack::resolve(&mAssetPack, fontPath);
+    if (font.packed) {
+        mRenderer.loadFontFromMemory(font.packed.bytes, font.packed.size);
+    } else {
+        mRenderer.loadFont(font.path);
+    }
+    PACMAN_LOG_INFO("[Game] Font loaded");
 
     mAudio.setMasterVolume(0.8f);
-    std::cerr << "[Game] Audio volume set" << std::endl;
-    
-    std::cerr << "[Game] Loading sounds..." << std::endl;
-    // Use the downloaded sound files
-    mAudio.loadSound("waka", tryResolveAsset("assets/sounds/eat.mp3"));
-    mAudio.loadSound("power", tryResolveAsset("assets/sounds/eat.mp3"));  // reuse eat sound
-    mAudio.loadSound("eat_ghost", tryResolveAsset("assets/sounds/eat.mp3"));  // reuse eat sound
-    mAudio.loadSound("death", tryResolveAsset("assets/sounds/death.wav"));
-    mAudio.loadSound("gameover", tryResolveAsset("assets/sounds/Pacman-death-sound.mp3"));
-    std::cerr << "[Game] Sounds loaded" << std::endl;
-
-    std::string musicPath = tryResolveAsset("assets/sounds/music.wav");
-    std::cerr << "[Game] Loading music from: " << musicPath << std::endl;
-    mAudio.playMusic(musicPath, true);
-    std::cerr << "[Game] Music started" << std::endl;
+    PACMAN_LOG_INFO("[Game] Audio volume set");
+    mEventSounds.fill(InvalidSound);
 
     // Preload a default level so the menu can render the maze as a background.
-    std::cerr << "[Game] Loading level 1..." << std::endl;
-    loadLevel(1);
-    std::cerr << "[Game] Level loaded" << std::endl;
-    
+    PACMAN_LOG_INFO("[Game] Loading level 1...");
+    mSim.setMapPaths("assets/maps/level1.txt", "assets/maps/fallback.txt");
+    mSim.loadLevel(1);
+    PACMAN_LOG_INFO("[Game] Level loaded");
+
     setState(State::MainMenu);
-    std::cerr << "[Game] Constructor complete!" << std::endl;
+    PACMAN_LOG_INFO("[Game] Constructor complete!");
 }
 
-int Game::run() {
-    sf::Clock clock;
+void Game::startAssetLoading() {
+    const unsigned threads = std::min(MaxAssetThreads, std::max(1u, std::thread::hardware_concurrency()));
+    mAssets = std::make_unique<AssetLoader>(&mAssetPack, threads);
 
-    constexpr float fixedDt = 1.f / 60.f;
-    float accumulator = 0.f;
+    const std::string atlasPath = "assets/sprites/atlas.bmp";
+    const std::string atlasJsonPath = "assets/sprites/atlas.json";
+    PACMAN_LOG_INFO("[Game] Loading atlas from: %s and %s", atlasPath.c_str(), atlasJsonPath.c_str());
+    mAssets->loadSpriteSheet(atlasPath, atlasJsonPath, [this](const std::vector<SpriteAtlas::Frame>* frames) {
+        if (frames) {
+            mRenderer.setAtlasFrames(*frames);
+        }
+    });
 
-    while (mWindow.isOpen()) {
-        processEvents();
+    const std::string backgroundPath = "assets/fonts/BackG.jpg";
+    PACMAN_LOG_INFO("[Game] Loading background from: %s", backgroundPath.c_str());
+    mAssets->loadImage(backgroundPath, [this](const sf::Image* image) {
+        if (image) {
+            mRenderer.setBackground(*image);
+        }
+    });
 
-        float dt = clock.restart().asSeconds();
-        if (dt > 0.25f) dt = 0.25f;
-        accumulator += dt;
+    PACMAN_LOG_INFO("[Game] Loading map sprites...");
+    const auto loadAtlasImage = [this](Renderer::AtlasImage which, const std::string& path) {
+        mAssets->loadImage(path, [this, which](const sf::Image* image) {
+            if (image) {
+                mRenderer.addAtlasImage(which, *image);
+            }
+        });
+    };
+    loadAtlasImage(Renderer::AtlasImage::Tile, "assets/sprites/tile.png");
+    loadAtlasImage(Renderer::AtlasImage::Dot, "assets/sprites/minicoin.png");
+    loadAtlasImage(Renderer::AtlasImage::PowerPellet, "assets/sprites/bigcoin.png");
+    loadAtlasImage(Renderer::AtlasImage::Heart, "assets/sprites/heart.png");
+
+    PACMAN_LOG_INFO("[Game] Loading sounds...");
+    const auto loadSound = [this](const std::string& id, const std::string& path) {
+        mAssets->loadSound(path, [this, id, path](const AssetLoader::SoundSamples* sound) {
+            if (sound) {
+                mAudio.loadSoundFromSamples(id, path, sound->samples.data(), sound->samples.size(),
+                                            sound->channelCount, sound->sampleRate);
+            }
+        });
+    };
+    // Three names share eat.mp3; the loader decodes it once and AudioManager keeps one buffer.
+    loadSound("waka", "assets/sounds/eat.mp3");
+    loadSound("power", "assets/sounds/eat.mp3");
+    loadSound("eat_ghost", "assets/sounds/eat.mp3");
+    loadSound("death", "assets/sounds/death.wav");
+    loadSound("gameover", "assets/sounds/Pacman-death-sound.mp3");
+}
 
-        while (accumulator >= fixedDt) {
-            update(fixedDt);
-            accumulator -= fixedDt;
-        }
+void Game::updateAssetLoading(bool wait) {
+    if (!mAssets) {
+        return;
+    }
+    if (wait) {
+        mAssets->finish();
+    }
+    if (!mAssets->poll()) {
+        return;
+    }
+    mAssets.reset();
+
+    mEventSounds[static_cast<std::size_t>(SimEvent::DotEaten)] = mAudio.findSound("waka");
+    mEventSounds[static_cast<std::size_t>(SimEvent::PowerPelletEaten)] = mAudio.findSound("power");
+    mEventSounds[static_cast<std::size_t>(SimEvent::FruitEaten)] = mAudio.findSound("power");
+    mEventSounds[static_cast<std::size_t>(SimEvent::GhostEaten)] = mAudio.findSound("eat_ghost");
+    mEventSounds[static_cast<std::size_t>(SimEvent::PlayerDied)] = mAudio.findSound("death");
+    mEventSounds[static_cast<std::size_t>(SimEvent::GameOver)] = mAudio.findSound("gameover");
+    PACMAN_LOG_INFO("[Game] Sounds loaded");
+
+    const std::string musicPath = "assets/sounds/music.wav";
+    PACMAN_LOG_INFO("[Game] Loading music from: %s", musicPath.c_str());
+    const AssetPack::Source music = AssetPack::resolve(&mAssetPack, musicPath);
+    if (music.packed) {
+        mAudio.playMusicFromMemory(music.packed.bytes, music.packed.size, true);
+    } else {
+        mAudio.playMusic(music.path, true);
+    }
+    PACMAN_LOG_INFO("[Game] Music started");
 
-        render();
+    PACMAN_LOG_INFO("[Game] Assets loaded %.1f ms after start",
+                    std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - mCreatedAt).count());
+}
+
+bool Game::recordTo(const std::string& path) {
+    if (!mRecorder.open(path, mSeed, mSim.mapPath())) {
+        return false;
     }
+    mSim.setRecorder(&mRecorder);
+    PACMAN_LOG_INFO("[Game] Recording replay to: %s", path.c_str());
+    return true;
+}
 
-    return 0;
+bool Game::playReplay(const std::string& path) {
+    if (!mReplay.open(path)) {
+        return false;
+    }
+    mSim.setRecorder(nullptr);
+    mSim.setMapPaths(mReplay.mapPath(), mSim.fallbackMapPath());
+    mSim.seed(mReplay.seed());
+    mReplaying = true;
+    PACMAN_LOG_INFO("[Game] Playing replay: %s", path.c_str());
+    return true;
 }
 
-void Game::setState(State s) {
-    std::cerr << "[Game] State changed to: " << static_cast<int>(s) << std::endl;
-    mState = s;
+void Game::setVsync(bool enabled) {
+    mVsync = enabled;
+    mWindow.setVerticalSyncEnabled(enabled);
+    PACMAN_LOG_INFO("[Game] VSync %s", enabled ? "enabled" : "disabled");
 }
 
-void Game::startNewGame() {
-    std::cerr << "[Game] Starting new game..." << std::endl;
-    mScore = 0;
-    mLives = 3;
-    mLevel = 1;
-    loadLevel(mLevel);
-    resetEntities();
-    setState(State::Playing);
-    std::cerr << "[Game] Map size: " << mMap.width() << "x" << mMap.height() << std::endl;
-    std::cerr << "[Game] Player spawn at: " << mPlayer.position().x << ", " << mPlayer.position().y << std::endl;
+void Game::setFramerateLimit(unsigned fps) {
+    mFramerateLimit = fps;
+    mWindow.setFramerateLimit(fps);
 }
 
-void Game::loadLevel(int level) {
-    (void)level;
+bool Game::measureLatency(const std::string& path) {
+    mLatencyOut.open(path, std::ios::trunc);
+    if (!mLatencyOut) {
+        PACMAN_LOG_ERROR("Failed to open latency log: %s", path.c_str());
+        return false;
+    }
+    mLatency = std::make_unique<LatencyStats>();
+    mSimThread.setInputTracing(true);
+    PACMAN_LOG_INFO("[Game] Measuring input latency to: %s", path.c_str());
+    return true;
+}
 
-    if (!mMap.loadFromFile(tryResolveAsset("assets/maps/level1.txt"))) {
-        // Fallback: minimal map.
-        std::cerr << "Using fallback map\n";
-        mMap.loadFromFile(tryResolveAsset("assets/maps/fallback.txt"));
+void Game::recordPresentedInputs(std::uint64_t presentedTick) {
+    // render() has returned, so display() has too: this is the photon timestamp.
+    const auto presentedAt = std::chrono::steady_clock::now();
+    for (const AppliedInput* in = mSimThread.tracedInput(); in != nullptr && in->visibleFromTick <= presentedTick; in = mSimThread.tracedInput()) {
+        mLatency->inputToTick.record(in->appliedAt - in->inputTime);
+        mLatency->tickToPhoton.record(presentedAt - in->appliedAt);
+        mLatency->inputToPhoton.record(presentedAt - in->inputTime);
+        mSimThread.popTracedInput();
     }
+}
 
-    // Renderer uses a fixed native 256x288 pixel buffer with a top HUD strip.
+void Game::writeLatencyReport() {
+    mLatencyOut << "vsync " << (mVsync ? 1 : 0) << "\n";
+    mLatencyOut << "framerate_limit " << mFramerateLimit << "\n";
+    mLatencyOut << "dropped_traces " << mSimThread.droppedTraces() << "\n";
+    mLatency->inputToTick.write(mLatencyOut, "input_to_tick");
+    mLatency->tickToPhoton.write(mLatencyOut, "tick_to_photon");
+    mLatency->inputToPhoton.write(mLatencyOut, "input_to_photon");
+    mLatencyOut.close();
+
+    PACMAN_LOG_INFO("[Game] Input to photon: p50 %g ms, p95 %g ms, p99 %g ms over %llu inputs",
+                    mLatency->inputToPhoton.percentileMs(0.50),
+                    mLatency->inputToPhoton.percentileMs(0.95),
+                    mLatency->inputToPhoton.percentileMs(0.99),
+                    static_cast<unsigned long long>(mLatency->inputToPhoton.count()));
+}
 
-    // Build ghosts once.
-    if (mGhosts.empty()) {
-        mGhosts.emplace_back(GhostId::Blinky, sf::Color(255, 60, 60));
-        mGhosts.emplace_back(GhostId::Pinky, sf::Color(255, 140, 200));
-        mGhosts.emplace_back(GhostId::Inky, sf::Color(60, 230, 230));
-        mGhosts.emplace_back(GhostId::Clyde, sf::Color(255, 170, 40));
+void Game::traceTo(const std::string& path) {
+    mTracePath = path;
+    if (!Profiler::Enabled) {
+        PACMAN_LOG_INFO("[Game] Built without PACMAN_PROFILE; no zones will be recorded");
     }
+}
+
+int Game::run() {
+    Profiler::setThreadName("main");
+    Log::setThreadName("main");
+    // Replays and latency runs measure steady frames, so they wait for every asset up front.
+    updateAssetLoading(mReplaying || mLatency);
+    if (mReplaying) {
+        const int result = runReplay();
+        if (!mTracePath.empty()) {
+            Profiler::writeChromeTrace(mTracePath);
+        }
+        return result;
+    }
+
+    mSimThread.start();
+    mControllerPoller.start();
 
-    // Mode schedule (classic-ish, simplified). Scatter/Chase alternating; last chase is "forever".
-    mModePhasesSeconds = {7.f, 20.f, 7.f, 20.f, 5.f, 20.f, 5.f, 9999.f};
-    mModePhaseIndex = 0;
-    mModeTimer = 0.f;
-    mBaseMode = GhostMode::Scatter;
+    while (mWindow.isOpen()) {
+        const std::uint64_t allocationsBefore = AllocationCounter::thisThread();
+        updateAssetLoading(false);
+        processEvents();
+        mSimThread.setActive(mState == State::Playing);
+        mControllerPoller.setEnabled(mState == State::Playing);
+
+        if (mSimThread.acquire()) {
+            syncRenderMap(mSimThread.snapshot());
+            handleSimEvents(mSimThread.snapshot());
+        }
+
+        // Blend from the previous tick towards the newest one by the time since its deadline.
+        const RenderSnapshot& snapshot = mSimThread.snapshot();
+        const float sinceTick = std::chrono::duration<float>(std::chrono::steady_clock::now() - snapshot.tickTime).count();
+        mRenderer.setInterpolationAlpha(sinceTick / Simulation::FixedDt);
 
-    mDotsEatenThisLevel = 0;
-    mFruitActive = false;
-    mFruitSpawnedThisLevel = false;
-    mFruitTimer = 0.f;
-    mFruitTile = mMap.fruitSpawn();
+        render(snapshot);
+        if (!mFirstFrameShown) {
+            mFirstFrameShown = true;
+            PACMAN_LOG_INFO("[Game] First frame %.1f ms after start",
+                            std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - mCreatedAt).count());
+        }
+        if (mLatency) {
+            recordPresentedInputs(snapshot.ticksRun);
+        }
+        mFrameAllocations = static_cast<std::uint32_t>(AllocationCounter::thisThread() - allocationsBefore);
+    }
 
-    resetEntities();
+    mControllerPoller.stop();
+    mSimThread.stop();
+    if (mLatency) {
+        writeLatencyReport();
+    }
+    if (!mTracePath.empty()) {
+        Profiler::writeChromeTrace(mTracePath);
+    }
+    return 0;
 }
 
-void Game::resetEntities() {
-    mPlayer.reset(mMap.playerSpawn(), mMap, mTileSize);
+int Game::runReplay() {
+    // No frame pacing: simulate recorded ticks until a display frame's worth of wall time has
+    // passed, then present. Sounds are skipped; they would only stack up at this speed.
+    mWindow.setVerticalSyncEnabled(false);
+    setState(State::Playing);
 
-    const TileCoord topLeft{1, 1};
-    const TileCoord topRight{mMap.width() - 2, 1};
-    const TileCoord bottomLeft{1, mMap.height() - 2};
-    const TileCoord bottomRight{mMap.width() - 2, mMap.height() - 2};
+    sf::Clock frameClock;
+    bool ended = false;
 
-    for (auto& g : mGhosts) {
-        TileCoord spawn = mMap.ghostSpawnBlinky();
-        TileCoord corner = topRight;
+    while (mWindow.isOpen()) {
+        sf::Event e;
+        while (mWindow.pollEvent(e)) {
+            if (e.type == sf::Event::Closed
+                || (e.type == sf::Event::KeyPressed && e.key.code == sf::Keyboard::Escape)) {
+                mWindow.close();
+                return 0;
+            }
+            if (e.type == sf::Event::Resized) {
+                mRenderer.handleResize();
+            }
+            if (e.type == sf::Event::KeyPressed && e.key.code == sf::Keyboard::F3) {
+                mRenderer.setPerfOverlayVisible(!mRenderer.perfOverlayVisible());
+            }
+        }
 
-        switch (g.id()) {
-        case GhostId::Blinky: spawn = mMap.ghostSpawnBlinky(); corner = topRight; break;
-        case GhostId::Pinky: spawn = mMap.ghostSpawnPinky(); corner = topLeft; break;
-        case GhostId::Inky: spawn = mMap.ghostSpawnInky(); corner = bottomRight; break;
-        case GhostId::Clyde: spawn = mMap.ghostSpawnClyde(); corner = bottomLeft; break;
+        while (!ended && frameClock.getElapsedTime().asSeconds() < Simulation::FixedDt) {
+            Direction requested = Direction::None;
+            switch (mReplay.next(requested)) {
+            case ReplayStep::Tick:
+                mSim.requestDirection(requested);
+                mLocalSnapshots.beforeTick(mSim);
+                mSim.update(Simulation::FixedDt);
+                mLocalSnapshots.afterTick(mSim);
+                if (mSim.isGameOver()) {
+                    setState(State::GameOver);
+                }
+                break;
+            case ReplayStep::NewGame:
+                startNewGame();
+                break;
+            case ReplayStep::End:
+                ended = true;
+                PACMAN_LOG_INFO("[Game] Replay finished after %llu ticks",
+                                static_cast<unsigned long long>(mReplay.ticksRead()));
+                setState(State::GameOver);
+                break;
+            }
         }
+        frameClock.restart();
 
-        g.reset(spawn, corner, mMap, mTileSize);
-        g.setMode(mBaseMode);
+        if (mLocalSnapshots.build(mSim, mLocalSnapshot, std::chrono::steady_clock::now())) {
+            syncRenderMap(mLocalSnapshot);
+        }
+        render(mLocalSnapshot);
     }
 
-    mFrightenedTimer = 0.f;
-    mFreezeTimer = 0.f;
+    return 0;
+}
+
+void Game::setState(State s) {
+    PACMAN_LOG_INFO("[Game] State changed to: %d", static_cast<int>(s));
+    mState = s;
+}
+
+void Game::startNewGame() {
+    PACMAN_LOG_INFO("[Game] Starting new game...");
+    if (mReplaying) {
+        mSim.startNewGame();
+        mLocalSnapshots.beforeTick(mSim);
+    } else {
+        mSimThread.requestNewGame();
+    }
+    setState(State::Playing);
+}
+
+void Game::requestDirection(Direction d) {
+    // SFML events carry no timestamp; the moment they are polled is the closest we have.
+    mSimThread.pushInput(InputSource::Window, d, std::chrono::steady_clock::now());
+}
+
+bool Game::pollEvent(sf::Event& e) {
+    std::lock_guard<std::mutex> lock(mJoystickMutex);
+    return mWindow.pollEvent(e);
+}
+
+void Game::syncRenderMap(const RenderSnapshot& snapshot) {
+    if (!snapshot.valid) {
+        return;
+    }
+    if (snapshot.layout != mRenderLayout) {
+        mRenderLayout = snapshot.layout;
+        mRenderMap = *mRenderLayout;
+    }
+    mRenderMap.readPelletBits(snapshot.state.dots.data(), snapshot.state.powerPellets.data());
 }
 
 void Game::processEvents() {
     sf::Event e;
-    while (mWindow.pollEvent(e)) {
+    while (pollEvent(e)) {
         if (e.type == sf::Event::Closed) {
             mWindow.close();
             return;
@@ -219,6 +407,16 @@ void Game::processEvents() {
             toggleFullscreen();
             continue;
         }
+        if (e.type == sf::Event::KeyPressed && e.key.code == sf::Keyboard::F3) {
+            mRenderer.setPerfOverlayVisible(!mRenderer.perfOverlayVisible());
+            continue;
+        }
+        if (e.type == sf::Event::KeyPressed && e.key.code == sf::Keyboard::F9 && !mTracePath.empty()) {
+            if (Profiler::writeChromeTrace(mTracePath)) {
+                PACMAN_LOG_INFO("[Game] Wrote trace: %s", mTracePath.c_str());
+            }
+            continue;
+        }
 
         if (mState == State::MainMenu) {
             // Handle mouse click for menu selection
@@ -276,10 +474,10 @@ void Game::processEvents() {
             if (e.type == sf::Event::KeyPressed) {
                 switch (e.key.code) {
                 case sf::Keyboard::Escape: setState(State::Paused); break;
-                case sf::Keyboard::Up: case sf::Keyboard::W: mPlayer.requestDirection(Direction::Up); break;
-                case sf::Keyboard::Down: case sf::Keyboard::S: mPlayer.requestDirection(Direction::Down); break;
-                case sf::Keyboard::Left: case sf::Keyboard::A: mPlayer.requestDirection(Direction::Left); break;
-                case sf::Keyboard::Right: case sf::Keyboard::D: mPlayer.requestDirection(Direction::Right); break;
+                case sf::Keyboard::Up: case sf::Keyboard::W: requestDirection(Direction::Up); break;
+                case sf::Keyboard::Down: case sf::Keyboard::S: requestDirection(Direction::Down); break;
+                case sf::Keyboard::Left: case sf::Keyboard::A: requestDirection(Direction::Left); break;
+                case sf::Keyboard::Right: case sf::Keyboard::D: requestDirection(Direction::Right); break;
                 default: break;
                 }
             }
@@ -356,252 +554,45 @@ void Game::processEvents() {
     }
 }
 
-void Game::pollControllerInput() {
-    if (!sf::Joystick::isConnected(0)) {
-        return;
-    }
-
-    // D-pad as POV is not standardized; use axes for a basic default.
-    const float x = sf::Joystick::getAxisPosition(0, sf::Joystick::X);
-    const float y = sf::Joystick::getAxisPosition(0, sf::Joystick::Y);
-
-    const float dead = 40.f;
-    if (std::abs(x) > std::abs(y)) {
-        if (x > dead) mPlayer.requestDirection(Direction::Right);
-        if (x < -dead) mPlayer.requestDirection(Direction::Left);
-    } else {
-        if (y > dead) mPlayer.requestDirection(Direction::Down);
-        if (y < -dead) mPlayer.requestDirection(Direction::Up);
-    }
-}
-
-void Game::updateGhostMode(float dt) {
-    if (mFrightenedTimer > 0.f) {
-        mFrightenedTimer -= dt;
-        if (mFrightenedTimer <= 0.f) {
-            mFrightenedTimer = 0.f;
-            // Restore base mode.
-            setAllGhostModes(mBaseMode, false);
-        }
-        return; // Freeze scatter/chase schedule while frightened (classic behavior).
-    }
-
-    mModeTimer += dt;
-
-    const float phaseLen = mModePhasesSeconds[std::min(mModePhaseIndex, mModePhasesSeconds.size() - 1)];
-    if (mModeTimer >= phaseLen) {
-        mModeTimer = 0.f;
-        mModePhaseIndex = std::min(mModePhaseIndex + 1, mModePhasesSeconds.size() - 1);
-
-        // Toggle Scatter <-> Chase.
-        mBaseMode = (mBaseMode == GhostMode::Scatter) ? GhostMode::Chase : GhostMode::Scatter;
-        setAllGhostModes(mBaseMode, true);
-    }
-}
-
-void Game::setAllGhostModes(GhostMode mode, bool reverse) {
-    for (auto& g : mGhosts) {
-        if (reverse) {
-            g.reverse();
-        }
-        // If the ghost is currently returning home (Eaten), leave it alone.
-        if (g.mode() != GhostMode::Eaten) {
-            g.setMode(mode);
-        }
-    }
-}
-
-TileCoord Game::chaseTargetFor(const Ghost& ghost) const {
-    const TileCoord pac = mPlayer.currentTile(mMap, mTileSize);
-
-    if (ghost.mode() == GhostMode::Scatter) {
-        return ghost.scatterCorner();
-    }
-
-    if (ghost.mode() == GhostMode::Eaten) {
-        return ghost.spawnTile();
-    }
-
-    // For Frightened we don't care; Ghost chooses random.
-    if (ghost.mode() == GhostMode::Frightened) {
-        return pac;
-    }
-
-    // Chase mode personalities.
-    const sf::Vector2i dir = dirToGridDelta(mPlayer.direction());
-
-    if (ghost.id() == GhostId::Blinky) {
-        return pac;
-    }
-
-    if (ghost.id() == GhostId::Pinky) {
-        TileCoord t{pac.x + 4 * dir.x, pac.y + 4 * dir.y};
-        return clampToMap(t, mMap);
-    }
-
-    if (ghost.id() == GhostId::Inky) {
-        const Ghost* blinky = nullptr;
-        for (const auto& g : mGhosts) {
-            if (g.id() == GhostId::Blinky) {
-                blinky = &g;
-                break;
-            }
-        }
-        const TileCoord twoAhead = clampToMap({pac.x + 2 * dir.x, pac.y + 2 * dir.y}, mMap);
-        if (!blinky) {
-            return twoAhead;
-        }
-        const TileCoord bTile = blinky->currentTile(mMap, mTileSize);
-        const TileCoord vec{twoAhead.x - bTile.x, twoAhead.y - bTile.y};
-        return clampToMap({bTile.x + 2 * vec.x, bTile.y + 2 * vec.y}, mMap);
-    }
-
-    // Clyde
-    const TileCoord cTile = ghost.currentTile(mMap, mTileSize);
-    const int dx = cTile.x - pac.x;
-    const int dy = cTile.y - pac.y;
-    const int d2 = dx * dx + dy * dy;
-    if (d2 > (8 * 8)) {
-        return pac;
-    }
-    return ghost.scatterCorner();
-}
-
-void Game::handlePlayerTile() {
-    const TileCoord t = mPlayer.currentTile(mMap, mTileSize);
-    const char c = mMap.cell(t.x, t.y);
-
-    if (c == '.') {
-        mScore += 10;
-        mDotsEatenThisLevel += 1;
-        mMap.setCell(t.x, t.y, ' ');
-        mAudio.playSound("waka");
-    } else if (c == 'o') {
-        mScore += 50;
-        mDotsEatenThisLevel += 1;
-        mMap.setCell(t.x, t.y, ' ');
-        mAudio.playSound("power");
-
-        mFrightenedTimer = 6.0f;
-        for (auto& g : mGhosts) {
-            if (g.mode() != GhostMode::Eaten) {
-                g.setMode(GhostMode::Frightened);
-                g.reverse();
-            }
-        }
-    }
-}
-
-void Game::updateFruit(float dt) {
-    // Classic-inspired: spawn a bonus fruit once per level after enough dots.
-    if (!mFruitSpawnedThisLevel && mDotsEatenThisLevel >= 50) {
-        mFruitSpawnedThisLevel = true;
-        mFruitActive = true;
-        mFruitTimer = 10.f;
-    }
-
-    if (mFruitActive) {
-        mFruitTimer -= dt;
-        if (mFruitTimer <= 0.f) {
-            mFruitActive = false;
-            mFruitTimer = 0.f;
-        }
-
-        const TileCoord t = mPlayer.currentTile(mMap, mTileSize);
-        if (t == mFruitTile) {
-            mFruitActive = false;
-            mFruitTimer = 0.f;
-            mScore += 500;
-            mAudio.playSound("power");
-        }
-    }
-}
-
-void Game::handleCollisions() {
-    const float hitR = mTileSize * 0.55f;
-    const float hitR2 = hitR * hitR;
-
-    for (auto& g : mGhosts) {
-        if (distSq(g.position(), mPlayer.position()) > hitR2) {
-            continue;
-        }
-
-        if (g.mode() == GhostMode::Frightened) {
-            mScore += 200;
-            g.setMode(GhostMode::Eaten);
-            mAudio.playSound("eat_ghost");
+void Game::handleSimEvents(const RenderSnapshot& snapshot) {
+    // One sound per kind per frame, however many ticks raised it.
+    for (std::size_t i = 0; i < SimEventKindCount; ++i) {
+        if (snapshot.eventCounts[i] == mSeenEventCounts[i]) {
             continue;
         }
+        mSeenEventCounts[i] = snapshot.eventCounts[i];
 
-        if (g.mode() == GhostMode::Eaten) {
-            continue;
-        }
-
-        // Player dies.
-        mLives -= 1;
-        mAudio.playSound("death");
-
-        if (mLives <= 0) {
-            mAudio.playSound("gameover");
+        mAudio.playSound(mEventSounds[i]);
+        if (static_cast<SimEvent>(i) == SimEvent::GameOver && mState == State::Playing) {
             setState(State::GameOver);
-            return;
         }
-
-        // Reset positions with a short freeze.
-        resetEntities();
-        mFreezeTimer = 0.8f;
-        return;
     }
 }
 
-void Game::update(float dt) {
-    if (mState != State::Playing) {
-        return;
-    }
-
-    pollControllerInput();
-
-    if (mFreezeTimer > 0.f) {
-        mFreezeTimer -= dt;
-        if (mFreezeTimer < 0.f) mFreezeTimer = 0.f;
-        return;
-    }
-
-    updateGhostMode(dt);
-
-    mPlayer.update(dt, mMap, mTileSize);
-    handlePlayerTile();
-    updateFruit(dt);
-
-    // Update ghosts
-    for (auto& g : mGhosts) {
-        const TileCoord target = chaseTargetFor(g);
-        g.update(dt, mMap, mTileSize, target, mRng);
-    }
-
-    handleCollisions();
-
-    if (!mMap.hasDotsOrPellets()) {
-        mLevel += 1;
-        loadLevel(mLevel);
-        setState(State::Playing);
-    }
-}
+void Game::render(const RenderSnapshot& snapshot) {
+    PACMAN_ZONE("Game::render");
+    mRenderer.setSimFrameStats(static_cast<int>(snapshot.ticksRun - mOverlayTicksRun),
+                               std::chrono::duration<float, std::milli>(snapshot.simTime - mOverlaySimTime).count());
+    mRenderer.setAllocationStats(static_cast<std::uint32_t>(snapshot.simAllocations - mOverlaySimAllocations), mFrameAllocations);
+    mOverlayTicksRun = snapshot.ticksRun;
+    mOverlaySimTime = snapshot.simTime;
+    mOverlaySimAllocations = snapshot.simAllocations;
 
-void Game::render() {
     mRenderer.beginFrame();
 
-    mRenderer.drawMap(mMap, mTileSize);
+    const float tileSize = snapshot.tileSize;
+    mRenderer.drawMap(mRenderMap, tileSize);
 
-    if (mState == State::Playing || mState == State::Paused || mState == State::GameOver) {
-        mRenderer.drawPlayer(mPlayer, mTileSize);
-        for (const auto& g : mGhosts) {
-            mRenderer.drawGhost(g, mTileSize);
+    if (snapshot.valid && (mState == State::Playing || mState == State::Paused || mState == State::GameOver)) {
+        const SimSnapshot& s = snapshot.state;
+        mRenderer.drawPlayer(s.player, snapshot.previousPlayerPosition, tileSize);
+        for (std::size_t i = 0; i < s.ghostCount; ++i) {
+            mRenderer.drawGhost(s.ghosts[i], snapshot.previousGhostPositions[i], tileSize);
         }
-        if (mFruitActive) {
-            mRenderer.drawFruit(mFruitTile, mTileSize);
+        if (s.fruitActive) {
+            mRenderer.drawFruit(s.fruitTile, tileSize);
         }
-        mRenderer.drawHUD(mScore, mLives, mLevel);
+        mRenderer.drawHUD(s.score, s.lives, s.level);
     }
 
     if (mState == State::MainMenu) {
@@ -615,22 +606,30 @@ void Game::render() {
             mRenderer.drawOverlayText("OPTIONS", "Arrows: change preset  Esc: back");
         }
 
+    if (mAssets) {
+        mRenderer.drawLoadingBar(mAssets->progress());
+    }
 
     mRenderer.endFrame();
 }
 
 void Game::toggleFullscreen() {
     mIsFullscreen = !mIsFullscreen;
-    
-    if (mIsFullscreen) {
-        // Get desktop video mode for fullscreen
-        sf::VideoMode desktop = sf::VideoMode::getDesktopMode();
-        mWindow.create(desktop, "Pac-Man (SFML)", sf::Style::Fullscreen);
-    } else {
-        // Return to windowed mode
-        mWindow.create(sf::VideoMode(960, 720), "Pac-Man (SFML)", sf::Style::Default);
+
+    {
+        // Creating a window refreshes SFML's joystick state, which the controller poller updates too.
+        std::lock_guard<std::mutex> lock(mJoystickMutex);
+        if (mIsFullscreen) {
+            // Get desktop video mode for fullscreen
+            sf::VideoMode desktop = sf::VideoMode::getDesktopMode();
+            mWindow.create(desktop, "Pac-Man (SFML)", sf::Style::Fullscreen);
+        } else {
+            // Return to windowed mode
+            mWindow.create(sf::VideoMode(960, 720), "Pac-Man (SFML)", sf::Style::Default);
+        }
     }
-    
-    mWindow.setVerticalSyncEnabled(true);
+
+    mWindow.setVerticalSyncEnabled(mVsync);
+    mWindow.setFramerateLimit(mFramerateLimit);
     mRenderer.handleResize();
 }
@@ -1,23 +1,46 @@
 #pragma once
 
+#include "AssetLoader.h"
+#include "AssetPack.h"
 #include "AudioManager.h"
-#include "Ghost.h"
-#include "Map.h"
+#include "ControllerPoller.h"
+#include "LatencyHistogram.h"
 #include "Menu.h"
-#include "Player.h"
 #include "Renderer.h"
+#include "Replay.h"
+#include "Simulation.h"
+#include "SimulationThread.h"
 
 #include <SFML/Graphics/RenderWindow.hpp>
 
-#include <random>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
 #include <string>
-#include <vector>
 
 class Game {
 public:
     Game();
     int run();
 
+    // Record every played tick to `path`. Call before run().
+    bool recordTo(const std::string& path);
+    // Replace interactive play with a recorded session, simulated as fast as the CPU allows.
+    bool playReplay(const std::string& path);
+
+    // Presentation options, so their latency cost can be measured. Call before run().
+    void setVsync(bool enabled);
+    void setFramerateLimit(unsigned fps);
+    // Trace every input through the tick that applies it to the display() that first shows
+    // it, and write p50/p95/p99 histograms to `path` when run() returns. Call before run().
+    bool measureLatency(const std::string& path);
+    // Write profiler zones as Chrome trace JSON to `path` on F9 and when run() returns.
+    // Needs a PACMAN_PROFILE build.
+    void traceTo(const std::string& path);
+
 private:
     enum class State {
         MainMenu,
@@ -27,67 +50,88 @@ private:
         Options,
     };
 
+    int runReplay();
+
     void processEvents();
-    void update(float dt);
-    void render();
+    // Window::pollEvent() also refreshes joysticks, so it shares a lock with ControllerPoller.
+    bool pollEvent(sf::Event& e);
+    void render(const RenderSnapshot& snapshot);
 
     void startNewGame();
-    void loadLevel(int level);
-    void resetEntities();
+    void requestDirection(Direction d);
+    void handleSimEvents(const RenderSnapshot& snapshot);
+    // Brings mRenderMap in line with a newly acquired snapshot.
+    void syncRenderMap(const RenderSnapshot& snapshot);
 
-    void updateGhostMode(float dt);
-    void setAllGhostModes(GhostMode mode, bool reverse);
+    void setState(State s);
 
-    void handlePlayerTile();
-    void updateFruit(float dt);
-    void handleCollisions();
+    // Queues every asset the first frame can do without on the loader threads.
+    void startAssetLoading();
+    // Uploads decoded assets (blocking until all are in when `wait`); once everything has
+    // arrived, resolves the event sounds, starts the music and drops the loader threads.
+    void updateAssetLoading(bool wait);
 
-    void pollControllerInput();
+    // Latency tracing: called right after the frame showing `presentedTick` was displayed.
+    void recordPresentedInputs(std::uint64_t presentedTick);
+    void writeLatencyReport();
 
-    TileCoord chaseTargetFor(const Ghost& ghost) const;
+    // First member, so time to first frame includes creating the window.
+    std::chrono::steady_clock::time_point mCreatedAt = std::chrono::steady_clock::now();
+    bool mFirstFrameShown = false;
 
-    void setState(State s);
+    // Declared before everything that may hold pointers into its mapping (font, music, loader).
+    AssetPack mAssetPack;
 
     sf::RenderWindow mWindow;
     Renderer mRenderer;
     AudioManager mAudio;
+    std::unique_ptr<AssetLoader> mAssets;
 
     State mState = State::MainMenu;
 
     Menu mMainMenu;
     Menu mPauseMenu;
 
-    Map mMap;
-    Player mPlayer;
-    std::vector<Ghost> mGhosts;
-
-    float mTileSize = 8.f;
-    float mHudHeight = 32.f;
-
-    int mScore = 0;
-    int mLives = 3;
-    int mLevel = 1;
-
-    int mDotsEatenThisLevel = 0;
-
-    bool mFruitActive = false;
-    bool mFruitSpawnedThisLevel = false;
-    float mFruitTimer = 0.f;
-    TileCoord mFruitTile{0, 0};
-
-    // Ghost mode schedule (Scatter/Chase).
-    GhostMode mBaseMode = GhostMode::Scatter;
-    float mModeTimer = 0.f;
-    std::vector<float> mModePhasesSeconds;
-    std::size_t mModePhaseIndex = 0;
-
-    // Frightened
-    float mFrightenedTimer = 0.f;
-
-    // Death / reset pacing
-    float mFreezeTimer = 0.f;
-
-    std::mt19937 mRng;
+    Simulation mSim;
+    std::uint32_t mSeed = 0;
+
+    ReplayWriter mRecorder;
+    ReplayReader mReplay;
+    bool mReplaying = false;
+
+    // Interactive play ticks mSim on this thread; the main thread only draws its snapshots.
+    // Replays tick on the main thread and build their snapshots locally.
+    SimulationThread mSimThread{mSim};
+    std::mutex mJoystickMutex;
+    ControllerPoller mControllerPoller{mSimThread, mJoystickMutex};
+    RenderSnapshotBuilder mLocalSnapshots;
+    RenderSnapshot mLocalSnapshot;
+
+    // Maze as of the newest snapshot: shared layout plus that snapshot's pellets.
+    Map mRenderMap;
+    std::shared_ptr<const Map> mRenderLayout;
+    std::array<std::uint32_t, SimEventKindCount> mSeenEventCounts{};
+    // Snapshot totals at the previous frame, for the per-frame figures of the perf overlay.
+    std::uint64_t mOverlayTicksRun = 0;
+    std::chrono::steady_clock::duration mOverlaySimTime{};
+    std::uint64_t mOverlaySimAllocations = 0;
+    // Main-thread heap allocations over the previous loop iteration.
+    std::uint32_t mFrameAllocations = 0;
+
+    // Sound per SimEvent kind, resolved once after loading.
+    std::array<SoundHandle, SimEventKindCount> mEventSounds{};
+
+    bool mVsync = true;
+    unsigned mFramerateLimit = 0;
+
+    struct LatencyStats {
+        LatencyHistogram inputToTick;   // input sampled -> tick applies it
+        LatencyHistogram tickToPhoton;  // tick applies it -> display() returns with it on screen
+        LatencyHistogram inputToPhoton; // end to end
+    };
+    std::unique_ptr<LatencyStats> mLatency;
+    std::ofstream mLatencyOut;
+    std::string mTracePath;
 
     // Fullscreen toggle
     bool mIsFullscreen = false;
@@ -1,80 +1,20 @@
 #include "Ghost.h"
 
 #include "Direction.h"
+#include "FlowField.h"
 #include "Map.h"
+#include "Profiler.h"
+#include "Random.h"
 
 #include <algorithm>
-#include <cmath>
 #include <limits>
-#include <queue>
-#include <vector>
 
-namespace {
-int bfsDistance(const Map& map, TileCoord start, TileCoord target) {
-    if (start == target) {
-        return 0;
-    }
-
-    const int w = map.width();
-    const int h = map.height();
-    if (w <= 0 || h <= 0) {
-        return -1;
-    }
-
-    auto idx = [w](TileCoord t) {
-        return t.y * w + t.x;
-    };
-
-    std::vector<int> dist(static_cast<std::size_t>(w * h), -1);
-    std::queue<TileCoord> q;
-
-    if (!map.isWalkable(start.x, start.y) || !map.isWalkable(target.x, target.y)) {
-        return -1;
-    }
-
-    dist[static_cast<std::size_t>(idx(start))] = 0;
-    q.push(start);
-
-    const Direction dirs[4] = {Direction::Up, Direction::Left, Direction::Down, Direction::Right};
-
-    while (!q.empty()) {
-        const TileCoord cur = q.front();
-        q.pop();
-
-        const int base = dist[static_cast<std::size_t>(idx(cur))];
-
-        for (Direction d : dirs) {
-            const TileCoord nxt = map.nextTile(cur, d);
-            if (nxt.x < 0 || nxt.y < 0 || nxt.x >= w || nxt.y >= h) {
-                continue;
-            }
-            if (!map.isWalkable(nxt.x, nxt.y)) {
-                continue;
-            }
-
-            const std::size_t ni = static_cast<std::size_t>(idx(nxt));
-            if (dist[ni] != -1) {
-                continue;
-            }
-
-            dist[ni] = base + 1;
-            if (nxt == target) {
-                return dist[ni];
-            }
-            q.push(nxt);
-        }
-    }
-
-    return -1;
-}
-}
-
-Ghost::Ghost(GhostId id, sf::Color baseColor) : mId(id), mBaseColor(baseColor) {}
+Ghost::Ghost(GhostId id) : mId(id) {}
 
 void Ghost::reset(TileCoord spawn, TileCoord scatterCorner, const Map& map, float tileSize) {
     mSpawn = spawn;
     mScatterCorner = scatterCorner;
-    mPos = map.tileCenterWorld(spawn, tileSize);
+    mMover.reset(spawn, map, tileSize);
     mDir = Direction::Left;
     mMode = GhostMode::Scatter;
 }
@@ -94,8 +34,14 @@ void Ghost::reverse() {
     mDir = opposite(mDir);
 }
 
-TileCoord Ghost::currentTile(const Map& map, float tileSize) const {
-    return map.worldToTile(mPos, tileSize);
+void Ghost::setSpeeds(float normal, float frightened, float eaten) {
+    mSpeedTilesPerSecond = normal;
+    mFrightenedSpeedTilesPerSecond = frightened;
+    mEatenSpeedTilesPerSecond = eaten;
+}
+
+TileCoord Ghost::currentTile(const Map& map, float /*tileSize*/) const {
+    return mMover.tile(map);
 }
 
 bool Ghost::canStep(Direction d, TileCoord from, const Map& map) const {
@@ -107,53 +53,69 @@ bool Ghost::canStep(Direction d, TileCoord from, const Map& map) const {
     return map.isWalkable(to.x, to.y);
 }
 
-Direction Ghost::chooseDirection(TileCoord from, const Map& map, TileCoord target, std::mt19937& rng) const {
+Direction Ghost::chooseDirection(TileCoord from, const Map& map, TileCoord target, std::mt19937& rng, FlowFieldCache& flowFields) const {
+    PACMAN_ZONE("Ghost::chooseDirection");
     Direction candidates[4] = {Direction::Up, Direction::Down, Direction::Left, Direction::Right};
 
-    std::vector<Direction> possible;
-    possible.reserve(4);
+    // At most four exits: a fixed array keeps this per-tick path off the heap.
+    Direction possible[4];
+    std::size_t count = 0;
 
     for (Direction d : candidates) {
         if (!canStep(d, from, map)) {
             continue;
         }
-        possible.push_back(d);
+        possible[count++] = d;
     }
 
-    if (possible.empty()) {
+    if (count == 0) {
         return Direction::None;
     }
 
     // Avoid reversing unless forced.
-    if (possible.size() > 1) {
+    if (count > 1) {
         const Direction rev = opposite(mDir);
-        possible.erase(std::remove(possible.begin(), possible.end(), rev), possible.end());
-        if (possible.empty()) {
-            possible.push_back(rev);
+        count = static_cast<std::size_t>(std::remove(possible, possible + count, rev) - possible);
+        if (count == 0) {
+            possible[count++] = rev;
         }
     }
 
+    Direction* const possibleEnd = possible + count;
+
     if (mMode == GhostMode::Frightened) {
-        std::uniform_int_distribution<int> dist(0, static_cast<int>(possible.size()) - 1);
-        return possible[static_cast<size_t>(dist(rng))];
+        return possible[pickIndex(rng, count)];
     }
 
     // Modernized classic: choose direction by shortest-path distance (BFS) to target.
     // Tie-break order uses the classic preference: Up, Left, Down, Right.
+    const NavTable* nav = map.navTable();
+    if (nav) {
+        // The table's first move already applies the same tie-break over all four directions;
+        // it stands unless it is the (excluded) reversal.
+        const Direction first = nav->firstMove(from, target);
+        if (first != Direction::None && std::find(possible, possibleEnd, first) != possibleEnd) {
+            return first;
+        }
+    }
+
+    // Without a table (large or edited mazes) read distances from the shared per-target field.
+    const FlowField* field = nav ? nullptr : &flowFields.field(map, target);
+
     const Direction pref[4] = {Direction::Up, Direction::Left, Direction::Down, Direction::Right};
 
-    Direction best = possible.front();
+    Direction best = possible[0];
     int bestDist = std::numeric_limits<int>::max();
 
     for (Direction dPref : pref) {
-        auto it = std::find(possible.begin(), possible.end(), dPref);
-        if (it == possible.end()) {
+        const Direction* it = std::find(possible, possibleEnd, dPref);
+        if (it == possibleEnd) {
             continue;
         }
 
         const Direction d = *it;
         const TileCoord to = map.nextTile(from, d);
-        const int dist = bfsDistance(map, to, target);
+        const int dist = nav ? nav->distance(to, target) : field->distance(to);
 
         const int score = (dist < 0) ? std::numeric_limits<int>::max() : dist;
         if (score < bestDist) {
@@ -165,22 +127,17 @@ Direction Ghost::chooseDirection(TileCoord from, const Map& map, TileCoord targe
     return best;
 }
 
-void Ghost::update(float dt, const Map& map, float tileSize, TileCoord target, std::mt19937& rng) {
+void Ghost::update(float dt, const Map& map, float tileSize, TileCoord target, std::mt19937& rng, FlowFieldCache& flowFields) {
+    PACMAN_ZONE("Ghost::update");
     // Speed by mode.
     float speedTiles = mSpeedTilesPerSecond;
-    if (mMode == GhostMode::Frightened) speedTiles = 4.0f;
-    if (mMode == GhostMode::Eaten) speedTiles = 8.5f;
+    if (mMode == GhostMode::Frightened) speedTiles = mFrightenedSpeedTilesPerSecond;
+    if (mMode == GhostMode::Eaten) speedTiles = mEatenSpeedTilesPerSecond;
 
     const TileCoord tile = currentTile(map, tileSize);
-    const sf::Vector2f center = map.tileCenterWorld(tile, tileSize);
-    const sf::Vector2f delta = {mPos.x - center.x, mPos.y - center.y};
-
-    const float epsilon = tileSize * 0.10f;
-    const bool nearCenter = (std::abs(delta.x) < epsilon) && (std::abs(delta.y) < epsilon);
+    const bool nearCenter = mMover.snapToCenter(tile, map);
 
     if (nearCenter) {
-        mPos = center;
-
         if (mMode == GhostMode::Eaten) {
             target = mSpawn;
         }
@@ -190,7 +147,7 @@ void Ghost::update(float dt, const Map& map, float tileSize, TileCoord target, s
             mMode = GhostMode::Scatter;
         }
 
-        const Direction newDir = chooseDirection(tile, map, target, rng);
+        const Direction newDir = chooseDirection(tile, map, target, rng, flowFields);
         if (newDir != Direction::None) {
             mDir = newDir;
         }
@@ -202,35 +159,9 @@ void Ghost::update(float dt, const Map& map, float tileSize, TileCoord target, s
         // Apply tunnel warp only from explicit endpoints.
         TileCoord warped;
         if (map.tryWarp(tile, mDir, warped)) {
-            mPos = map.tileCenterWorld(warped, tileSize);
+            mMover.placeAt(warped, map);
         }
     }
 
-    const sf::Vector2f dir = dirToUnitVector(mDir);
-    const float speed = speedTiles * tileSize;
-
-    // Probe slightly ahead to simulate a smaller hitbox against walls.
-    const float probe = tileSize * 0.20f;
-    sf::Vector2f newPos = mPos;
-    newPos.x += dir.x * speed * dt;
-    newPos.y += dir.y * speed * dt;
-    const sf::Vector2f probePos{newPos.x + dir.x * probe, newPos.y + dir.y * probe};
-    const TileCoord newTile = map.worldToTile(probePos, tileSize);
-
-    if (map.isWalkable(newTile.x, newTile.y)) {
-        mPos = newPos;
-    } else if (nearCenter) {
-        mPos = center;
-        mDir = Direction::None;
-    }
-}
-
-sf::Color Ghost::color() const {
-    if (mMode == GhostMode::Frightened) {
-        return sf::Color(60, 60, 255);
-    }
-    if (mMode == GhostMode::Eaten) {
-        return sf::Color(220, 220, 255);
-    }
-    return mBaseColor;
+    mMover.advance(mDir, speedTiles, dt, map, tile, nearCenter);
 }
@@ -1,11 +1,12 @@
 #pragma once
 
+#include "GridMover.h"
 #include "Types.h"
-#include <SFML/Graphics/Color.hpp>
 #include <SFML/System/Vector2.hpp>
 
 #include <random>
 
+class FlowFieldCache;
 class Map;
 
 enum class GhostId : std::uint8_t {
@@ -24,7 +25,8 @@ enum class GhostMode : std::uint8_t {
 
 class Ghost {
 public:
-    Ghost(GhostId id, sf::Color baseColor);
+    Ghost() = default;
+    explicit Ghost(GhostId id);
 
     void reset(TileCoord spawn, TileCoord scatterCorner, const Map& map, float tileSize);
 
@@ -33,14 +35,17 @@ public:
 
     void reverse();
 
-    void update(float dt, const Map& map, float tileSize, TileCoord target, std::mt19937& rng);
+    // Tiles per second in Scatter/Chase, while Frightened and while Eaten.
+    void setSpeeds(float normal, float frightened, float eaten);
 
-    sf::Vector2f position() const { return mPos; }
+    void update(float dt, const Map& map, float tileSize, TileCoord target, std::mt19937& rng, FlowFieldCache& flowFields);
+
+    sf::Vector2f position() const { return mMover.position(); }
+    const GridMover& mover() const { return mMover; }
     Direction direction() const { return mDir; }
 
     TileCoord currentTile(const Map& map, float tileSize) const;
 
-    sf::Color color() const;
     GhostId id() const { return mId; }
 
     TileCoord spawnTile() const { return mSpawn; }
@@ -49,12 +54,11 @@ public:
 private:
     bool canStep(Direction d, TileCoord from, const Map& map) const;
 
-    Direction chooseDirection(TileCoord from, const Map& map, TileCoord target, std::mt19937& rng) const;
+    Direction chooseDirection(TileCoord from, const Map& map, TileCoord target, std::mt19937& rng, FlowFieldCache& flowFields) const;
 
-    GhostId mId;
-    sf::Color mBaseColor;
+    GhostId mId = GhostId::Blinky;
 
-    sf::Vector2f mPos{0.f, 0.f};
+    GridMover mMover;
     Direction mDir = Direction::Left;
     GhostMode mMode = GhostMode::Scatter;
 
@@ -62,4 +66,6 @@ private:
     TileCoord mScatterCorner{1, 1};
 
     float mSpeedTilesPerSecond = 7.0f;
+    float mFrightenedSpeedTilesPerSecond = 4.0f;
+    float mEatenSpeedTilesPerSecond = 8.5f;
 };
@@ -0,0 +1,141 @@
+#include "GridMover.h"
+
+#include "Direction.h"
+#include "Map.h"
+
+#include <cmath>
+#include <cstdlib>
+
+#if PACMAN_FIXED_POINT
+
+namespace {
+// Turning window and wall probe, as fractions of a tile (0.10 and 0.20 in float builds).
+constexpr int SnapWindow = GridMover::SubUnits / 10;
+constexpr int ProbeDistance = GridMover::SubUnits / 5;
+
+int centerSub(int tile) {
+    return tile * GridMover::SubUnits + GridMover::SubUnits / 2;
+}
+
+// Speeds are authored as float tiles/second; they are exact multiples of 1/SubUnits, so the
+// rounding is exact and identical everywhere.
+std::int32_t toSubUnits(float tiles) {
+    return static_cast<std::int32_t>(std::lround(tiles * static_cast<float>(GridMover::SubUnits)));
+}
+}
+
+void GridMover::reset(TileCoord tile, const Map& map, float tileSize) {
+    mTileSize = tileSize;
+    mStepRemainder = 0;
+    placeAt(tile, map);
+}
+
+TileCoord GridMover::tile(const Map& /*map*/) const {
+    return {mSub.x / SubUnits, mSub.y / SubUnits};
+}
+
+sf::Vector2f GridMover::position() const {
+    const float scale = mTileSize / static_cast<float>(SubUnits);
+    return {static_cast<float>(mSub.x) * scale, static_cast<float>(mSub.y) * scale};
+}
+
+bool GridMover::snapToCenter(TileCoord tile, const Map& map) {
+    const int dx = mSub.x - centerSub(tile.x);
+    const int dy = mSub.y - centerSub(tile.y);
+    if (std::abs(dx) >= SnapWindow || std::abs(dy) >= SnapWindow) {
+        return false;
+    }
+    placeAt(tile, map);
+    return true;
+}
+
+void GridMover::placeAt(TileCoord tile, const Map& /*map*/) {
+    mSub = {centerSub(tile.x), centerSub(tile.y)};
+}
+
+void GridMover::advance(Direction& dir, float speedTilesPerSecond, float /*dt*/, const Map& map, TileCoord startTile, bool atCenter) {
+    // One step per call: carry the sub-unit remainder so the average speed is exact.
+    mStepRemainder += toSubUnits(speedTilesPerSecond);
+    const int step = mStepRemainder / StepsPerSecond;
+    mStepRemainder %= StepsPerSecond;
+
+    const sf::Vector2i delta = dirToGridDelta(dir);
+    const sf::Vector2i next{mSub.x + delta.x * step, mSub.y + delta.y * step};
+    const TileCoord probeTile{(next.x + delta.x * ProbeDistance) / SubUnits, (next.y + delta.y * ProbeDistance) / SubUnits};
+
+    if (map.isWalkable(probeTile.x, probeTile.y)) {
+        mSub = next;
+    } else if (atCenter) {
+        placeAt(startTile, map);
+        dir = Direction::None;
+    }
+}
+
+bool GridMover::overlaps(const GridMover& other, float radiusTiles) const {
+    const std::int64_t dx = mSub.x - other.mSub.x;
+    const std::int64_t dy = mSub.y - other.mSub.y;
+    const std::int64_t r = static_cast<std::int64_t>(std::lround(radiusTiles * static_cast<float>(SubUnits)));
+    return dx * dx + dy * dy <= r * r;
+}
+
+#else
+
+void GridMover::reset(TileCoord tile, const Map& map, float tileSize) {
+    mTileSize = tileSize;
+    placeAt(tile, map);
+}
+
+TileCoord GridMover::tile(const Map& map) const {
+    return map.worldToTile(mPos, mTileSize);
+}
+
+sf::Vector2f GridMover::position() const {
+    return mPos;
+}
+
+bool GridMover::snapToCenter(TileCoord tile, const Map& map) {
+    const sf::Vector2f center = map.tileCenterWorld(tile, mTileSize);
+    const sf::Vector2f delta = {mPos.x - center.x, mPos.y - center.y};
+
+    const float epsilon = mTileSize * 0.10f;
+    if (!(std::abs(delta.x) < epsilon) || !(std::abs(delta.y) < epsilon)) {
+        return false;
+    }
+
+    // Snap to center to avoid drift.
+    mPos = center;
+    return true;
+}
+
+void GridMover::placeAt(TileCoord tile, const Map& map) {
+    mPos = map.tileCenterWorld(tile, mTileSize);
+}
+
+void GridMover::advance(Direction& dir, float speedTilesPerSecond, float dt, const Map& map, TileCoord startTile, bool atCenter) {
+    const sf::Vector2f unit = dirToUnitVector(dir);
+    const float speed = speedTilesPerSecond * mTileSize;
+
+    // Probe slightly ahead to simulate a smaller hitbox against walls.
+    const float probe = mTileSize * 0.20f;
+    sf::Vector2f newPos = mPos;
+    newPos.x += unit.x * speed * dt;
+    newPos.y += unit.y * speed * dt;
+    const sf::Vector2f probePos{newPos.x + unit.x * probe, newPos.y + unit.y * probe};
+    const TileCoord newTile = map.worldToTile(probePos, mTileSize);
+
+    if (map.isWalkable(newTile.x, newTile.y)) {
+        mPos = newPos;
+    } else if (atCenter) {
+        placeAt(startTile, map);
+        dir = Direction::None;
+    }
+}
+
+bool GridMover::overlaps(const GridMover& other, float radiusTiles) const {
+    const float dx = mPos.x - other.mPos.x;
+    const float dy = mPos.y - other.mPos.y;
+    const float r = mTileSize * radiusTiles;
+    return !(dx * dx + dy * dy > r * r);
+}
+
+#endif
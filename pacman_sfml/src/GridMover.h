@@ -0,0 +1,51 @@
+#pragma once
+
+#include "Types.h"
+#include <SFML/System/Vector2.hpp>
+
+#include <cstdint>
+
+#ifndef PACMAN_FIXED_POINT
+#define PACMAN_FIXED_POINT 0
+#endif
+
+class Map;
+
+// Tile-grid position and motion shared by Pac-Man and the ghosts.
+//
+// Default builds integrate a float world position. With PACMAN_FIXED_POINT the position is
+// kept in integer sub-tile units and every update() advances exactly one simulation step, so
+// the same seed and inputs give bit-identical state on every compiler, flag set and CPU.
+class GridMover {
+public:
+    // Simulation steps per second; Simulation::FixedDt is derived from this.
+    static constexpr int StepsPerSecond = 60;
+    // Sub-tile resolution of the fixed-point representation.
+    static constexpr int SubUnits = 256;
+
+    void reset(TileCoord tile, const Map& map, float tileSize);
+
+    TileCoord tile(const Map& map) const;
+    sf::Vector2f position() const;
+
+    // Snaps onto the centre of `tile` when within the turning window; returns whether it did.
+    bool snapToCenter(TileCoord tile, const Map& map);
+    // Jumps to the centre of `tile` (tunnel warps).
+    void placeAt(TileCoord tile, const Map& map);
+
+    // Moves one step along `dir`. If a probe slightly ahead hits a wall the mover stays put, or,
+    // when it started this step at a tile centre, parks on `startTile` and clears `dir`.
+    void advance(Direction& dir, float speedTilesPerSecond, float dt, const Map& map, TileCoord startTile, bool atCenter);
+
+    // True when the centres are at most `radiusTiles` apart.
+    bool overlaps(const GridMover& other, float radiusTiles) const;
+
+private:
+    float mTileSize = 8.f;
+#if PACMAN_FIXED_POINT
+    sf::Vector2i mSub{0, 0};
+    std::int32_t mStepRemainder = 0;
+#else
+    sf::Vector2f mPos{0.f, 0.f};
+#endif
+};
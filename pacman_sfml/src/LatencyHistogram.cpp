@@ -0,0 +1,56 @@
+#include "LatencyHistogram.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+double nanosToMs(std::int64_t nanos) {
+    return static_cast<double>(nanos) / 1.0e6;
+}
+}
+
+void LatencyHistogram::record(std::chrono::nanoseconds latency) {
+    const std::int64_t nanos = std::max<std::int64_t>(latency.count(), 0);
+    const std::size_t bucket = std::min<std::size_t>(static_cast<std::size_t>(nanos / BucketNanos), BucketCount - 1);
+    ++mBuckets[bucket];
+    ++mCount;
+    mSumNanos += nanos;
+    mMaxNanos = std::max(mMaxNanos, nanos);
+}
+
+double LatencyHistogram::meanMs() const {
+    return mCount == 0 ? 0.0 : nanosToMs(mSumNanos) / static_cast<double>(mCount);
+}
+
+double LatencyHistogram::maxMs() const {
+    return nanosToMs(mMaxNanos);
+}
+
+double LatencyHistogram::percentileMs(double p) const {
+    if (mCount == 0) {
+        return 0.0;
+    }
+    const auto rank = static_cast<std::uint64_t>(std::ceil(std::clamp(p, 0.0, 1.0) * static_cast<double>(mCount)));
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < mBuckets.size(); ++i) {
+        seen += mBuckets[i];
+        if (seen >= std::max<std::uint64_t>(rank, 1)) {
+            return std::min(nanosToMs(static_cast<std::int64_t>(i + 1) * BucketNanos), maxMs());
+        }
+    }
+    return maxMs();
+}
+
+void LatencyHistogram::write(std::ostream& out, const std::string& name) const {
+    out << name << "_count " << mCount << "\n";
+    out << name << "_mean_ms " << meanMs() << "\n";
+    out << name << "_p50_ms " << percentileMs(0.50) << "\n";
+    out << name << "_p95_ms " << percentileMs(0.95) << "\n";
+    out << name << "_p99_ms " << percentileMs(0.99) << "\n";
+    out << name << "_max_ms " << maxMs() << "\n";
+    for (std::size_t i = 0; i < mBuckets.size(); ++i) {
+        if (mBuckets[i] != 0) {
+            out << name << "_hist " << nanosToMs(static_cast<std::int64_t>(i) * BucketNanos) << " " << mBuckets[i] << "\n";
+        }
+    }
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Latency distribution with fixed 50 us buckets up to one second; slower samples share the
+// last bucket. Buckets are allocated once up front, so record() never allocates.
+class LatencyHistogram {
+public:
+    static constexpr std::int64_t BucketNanos = 50'000;
+    static constexpr std::size_t BucketCount = 20'000;
+
+    LatencyHistogram() : mBuckets(BucketCount, 0) {}
+
+    void record(std::chrono::nanoseconds latency);
+
+    std::uint64_t count() const { return mCount; }
+    double meanMs() const;
+    double maxMs() const;
+    // `p` in [0, 1]; upper edge of the bucket holding that quantile.
+    double percentileMs(double p) const;
+
+    // "<name>_count", "_mean_ms", "_p50_ms", "_p95_ms", "_p99_ms", "_max_ms" lines, then one
+    // "<name>_hist <bucket start ms> <samples>" line per non-empty bucket.
+    void write(std::ostream& out, const std::string& name) const;
+
+private:
+    std::vector<std::uint32_t> mBuckets;
+    std::uint64_t mCount = 0;
+    std::int64_t mSumNanos = 0;
+    std::int64_t mMaxNanos = 0;
+};
@@ -0,0 +1,346 @@
+#include "Log.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+constexpr std::size_t LineSize = 256;
+constexpr std::size_t RingSize = 512;
+constexpr std::size_t MaxThreads = 64;
+// Lines per thread written by the crash dump.
+constexpr std::size_t CrashLines = 32;
+constexpr auto WriterInterval = std::chrono::milliseconds(50);
+
+struct Entry {
+    std::uint64_t nanos = 0;
+    std::size_t length = 0;
+    char text[LineSize];
+};
+
+// Single producer (the owning thread), single consumer (the writer thread). Slots are only
+// reused once the writer has read them, so a full ring drops new lines instead of blocking.
+struct ThreadRing {
+    std::atomic<const char*> name{nullptr};
+    std::uint32_t id = 0;
+    std::atomic<std::uint64_t> written{0};
+    std::atomic<std::uint64_t> read{0};
+    std::atomic<std::uint64_t> dropped{0};
+    std::uint64_t droppedReported = 0; // writer only
+    Entry entries[RingSize];
+};
+
+// Rings are never freed: the writer drains lines from finished threads, and the crash handler
+// may read any ring at any moment without taking a lock.
+std::array<std::atomic<ThreadRing*>, MaxThreads> gRings{};
+std::atomic<std::size_t> gRingCount{0};
+
+const auto gStart = std::chrono::steady_clock::now();
+
+std::atomic<bool> gRunning{false};
+std::atomic<bool> gStopping{false};
+std::mutex gWakeMutex;
+std::condition_variable gWake;
+std::thread gWriter;
+std::FILE* gFile = nullptr;
+int gFileDescriptor = -1;
+
+std::atomic<bool> gCrashed{false};
+std::terminate_handler gPreviousTerminate = nullptr;
+
+ThreadRing* registerThread() {
+    const std::size_t index = gRingCount.fetch_add(1);
+    if (index >= MaxThreads) {
+        return nullptr;
+    }
+    auto* ring = new ThreadRing;
+    ring->id = static_cast<std::uint32_t>(index + 1);
+    gRings[index].store(ring, std::memory_order_release);
+    return ring;
+}
+
+ThreadRing* localRing() {
+    thread_local ThreadRing* const ring = registerThread();
+    return ring;
+}
+
+std::size_t ringCount() {
+    return std::min(gRingCount.load(std::memory_order_acquire), MaxThreads);
+}
+
+std::uint64_t nanosSinceStart() {
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - gStart).count());
+}
+
+const char* levelTag(LogLevel level) {
+    switch (level) {
+    case LogLevel::Debug:   return "DEBUG";
+    case LogLevel::Info:    return "INFO";
+    case LogLevel::Warning: return "WARN";
+    case LogLevel::Error:   return "ERROR";
+    }
+    return "?";
+}
+
+void writeSinks(const char* text, std::size_t length) {
+    std::fwrite(text, 1, length, stderr);
+    if (gFile != nullptr) {
+        std::fwrite(text, 1, length, gFile);
+    }
+}
+
+void flushSinks() {
+    std::fflush(stderr);
+    if (gFile != nullptr) {
+        std::fflush(gFile);
+    }
+}
+
+// Writes every queued line in timestamp order. Called by the writer thread, and by stop() once
+// the writer has been joined, so there is always a single consumer.
+void drainRings(std::vector<const Entry*>& pending) {
+    pending.clear();
+    std::array<std::uint64_t, MaxThreads> ends{};
+    const std::size_t count = ringCount();
+    for (std::size_t i = 0; i < count; ++i) {
+        const ThreadRing* ring = gRings[i].load(std::memory_order_acquire);
+        if (ring == nullptr) {
+            continue;
+        }
+        ends[i] = ring->written.load(std::memory_order_acquire);
+        for (std::uint64_t r = ring->read.load(std::memory_order_relaxed); r < ends[i]; ++r) {
+            pending.push_back(&ring->entries[r % RingSize]);
+        }
+    }
+    std::stable_sort(pending.begin(), pending.end(),
+                     [](const Entry* a, const Entry* b) { return a->nanos < b->nanos; });
+    bool wrote = !pending.empty();
+    for (const Entry* entry : pending) {
+        writeSinks(entry->text, entry->length);
+    }
+
+    for (std::size_t i = 0; i < count; ++i) {
+        ThreadRing* ring = gRings[i].load(std::memory_order_acquire);
+        if (ring == nullptr) {
+            continue;
+        }
+        // Lines queued after the snapshot above wait for the next pass.
+        ring->read.store(ends[i], std::memory_order_release);
+
+        const std::uint64_t dropped = ring->dropped.load(std::memory_order_relaxed);
+        if (dropped != ring->droppedReported) {
+            char line[LineSize];
+            const int length = std::snprintf(line, sizeof(line), "[Log] thread %u dropped %llu lines\n",
+                                             static_cast<unsigned>(ring->id),
+                                             static_cast<unsigned long long>(dropped - ring->droppedReported));
+            writeSinks(line, static_cast<std::size_t>(std::max(length, 0)));
+            ring->droppedReported = dropped;
+            wrote = true;
+        }
+    }
+    if (wrote) {
+        flushSinks();
+    }
+}
+
+void writerLoop() {
+    std::vector<const Entry*> pending;
+    pending.reserve(MaxThreads * RingSize);
+    std::unique_lock<std::mutex> lock(gWakeMutex);
+    while (!gStopping.load()) {
+        gWake.wait_for(lock, WriterInterval);
+        lock.unlock();
+        drainRings(pending);
+        lock.lock();
+    }
+}
+
+void writeRaw(int fd, const char* text, std::size_t length) {
+    if (fd < 0) {
+        return;
+    }
+#ifdef _WIN32
+    _write(fd, text, static_cast<unsigned>(length));
+#else
+    while (length > 0) {
+        const ssize_t n = ::write(fd, text, length);
+        if (n <= 0) {
+            return;
+        }
+        text += n;
+        length -= static_cast<std::size_t>(n);
+    }
+#endif
+}
+
+void writeRawBoth(const char* text, std::size_t length) {
+    writeRaw(2, text, length);
+    writeRaw(gFileDescriptor, text, length);
+}
+
+// Runs inside a signal handler: no locks, no allocation, no stdio. The newest lines of each
+// thread are still in its ring whether or not the writer has reached them.
+void dumpRecent(const char* reason) {
+    if (gCrashed.exchange(true)) {
+        return;
+    }
+    const char header[] = "\n=== crash: ";
+    const char trailer[] = "; most recent log lines per thread ===\n";
+    writeRawBoth(header, sizeof(header) - 1);
+    writeRawBoth(reason, std::strlen(reason));
+    writeRawBoth(trailer, sizeof(trailer) - 1);
+
+    const std::size_t count = ringCount();
+    for (std::size_t i = 0; i < count; ++i) {
+        const ThreadRing* ring = gRings[i].load(std::memory_order_acquire);
+        if (ring == nullptr) {
+            continue;
+        }
+        const std::uint64_t end = ring->written.load(std::memory_order_acquire);
+        const std::uint64_t begin = end > CrashLines ? end - CrashLines : 0;
+        for (std::uint64_t r = begin; r < end; ++r) {
+            const Entry& entry = ring->entries[r % RingSize];
+            writeRawBoth(entry.text, std::min(entry.length, LineSize));
+        }
+    }
+}
+
+const char* signalName(int signal) {
+    switch (signal) {
+    case SIGSEGV: return "SIGSEGV";
+    case SIGABRT: return "SIGABRT";
+    case SIGFPE:  return "SIGFPE";
+    case SIGILL:  return "SIGILL";
+    default:      return "signal";
+    }
+}
+
+void onFatalSignal(int signal) {
+    dumpRecent(signalName(signal));
+    std::signal(signal, SIG_DFL);
+    std::raise(signal);
+}
+
+void onTerminate() {
+    dumpRecent("std::terminate");
+    if (gPreviousTerminate != nullptr) {
+        gPreviousTerminate();
+    }
+    std::abort();
+}
+
+void installCrashHandlers() {
+    for (int signal : {SIGSEGV, SIGABRT, SIGFPE, SIGILL}) {
+        std::signal(signal, onFatalSignal);
+    }
+    gPreviousTerminate = std::set_terminate(onTerminate);
+}
+}
+
+bool Log::start(const std::string& path) {
+    if (gRunning.load()) {
+        return true;
+    }
+    bool opened = true;
+    if (!path.empty()) {
+        gFile = std::fopen(path.c_str(), "w");
+        if (gFile == nullptr) {
+            std::fprintf(stderr, "Failed to open log file: %s\n", path.c_str());
+            opened = false;
+        } else {
+#ifdef _WIN32
+            gFileDescriptor = _fileno(gFile);
+#else
+            gFileDescriptor = fileno(gFile);
+#endif
+        }
+    }
+    installCrashHandlers();
+    gStopping.store(false);
+    gWriter = std::thread(writerLoop);
+    gRunning.store(true, std::memory_order_release);
+    return opened;
+}
+
+void Log::stop() {
+    if (!gRunning.exchange(false)) {
+        return;
+    }
+    gStopping.store(true);
+    gWake.notify_one();
+    gWriter.join();
+
+    std::vector<const Entry*> pending;
+    drainRings(pending);
+    if (gFile != nullptr) {
+        gFileDescriptor = -1;
+        std::fclose(gFile);
+        gFile = nullptr;
+    }
+}
+
+void Log::setThreadName(const char* name) {
+    if (ThreadRing* ring = localRing()) {
+        ring->name.store(name, std::memory_order_relaxed);
+    }
+}
+
+void Log::write(LogLevel level, const char* format, ...) {
+    ThreadRing* ring = localRing();
+    const std::uint64_t nanos = nanosSinceStart();
+
+    char line[LineSize];
+    const char* name = ring != nullptr ? ring->name.load(std::memory_order_relaxed) : nullptr;
+    int header = name != nullptr
+        ? std::snprintf(line, LineSize, "%9.3f %-5s %-10s ", static_cast<double>(nanos) * 1e-9,
+                        levelTag(level), name)
+        : std::snprintf(line, LineSize, "%9.3f %-5s thread %-3u ", static_cast<double>(nanos) * 1e-9,
+                        levelTag(level), ring != nullptr ? static_cast<unsigned>(ring->id) : 0u);
+    std::size_t length = static_cast<std::size_t>(std::clamp(header, 0, static_cast<int>(LineSize - 1)));
+
+    std::va_list args;
+    va_start(args, format);
+    const int body = std::vsnprintf(line + length, LineSize - length, format, args);
+    va_end(args);
+    // Truncated lines keep their newline.
+    length = std::min(length + static_cast<std::size_t>(std::max(body, 0)), LineSize - 2);
+    line[length++] = '\n';
+
+    if (ring == nullptr || !gRunning.load(std::memory_order_acquire)) {
+        std::fwrite(line, 1, length, stderr);
+        return;
+    }
+
+    const std::uint64_t index = ring->written.load(std::memory_order_relaxed);
+    if (index - ring->read.load(std::memory_order_acquire) >= RingSize) {
+        ring->dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    Entry& entry = ring->entries[index % RingSize];
+    entry.nanos = nanos;
+    entry.length = length;
+    std::memcpy(entry.text, line, length);
+    ring->written.store(index + 1, std::memory_order_release);
+
+    if (level >= LogLevel::Warning) {
+        gWake.notify_one();
+    }
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+// Lowest level compiled in: 0 debug, 1 info, 2 warning, 3 error. Calls below it vanish, arguments
+// included.
+#ifndef PACMAN_LOG_LEVEL
+#define PACMAN_LOG_LEVEL 1
+#endif
+
+enum class LogLevel : std::uint8_t {
+    Debug,
+    Info,
+    Warning,
+    Error
+};
+
+// Asynchronous logger. A call formats its line with printf-style arguments into the calling
+// thread's fixed ring and returns; no lock, no allocation after the thread's first line, no I/O.
+// A background thread started by start() drains every ring to stderr and the log file. Before
+// start() and after stop() lines go straight to stderr, so tools that never start it still print.
+// A crash (fatal signal or std::terminate) writes each thread's most recent lines before dying.
+class Log {
+public:
+    static constexpr LogLevel MinLevel = static_cast<LogLevel>(PACMAN_LOG_LEVEL);
+
+    // Starts the writer thread and installs the crash handlers. An empty path logs to stderr only.
+    // False when the file cannot be opened; logging to stderr still works.
+    static bool start(const std::string& path);
+    // Writes everything still queued and joins the writer thread.
+    static void stop();
+
+    // Label for the calling thread in log lines and crash dumps; literals only, the pointer is kept.
+    static void setThreadName(const char* name);
+
+#if defined(__GNUC__) || defined(__clang__)
+    __attribute__((format(printf, 2, 3)))
+#endif
+    static void write(LogLevel level, const char* format, ...);
+};
+
+#define PACMAN_LOG(level, ...)                                           \
+    do {                                                                 \
+        if constexpr ((level) >= Log::MinLevel) {                        \
+            Log::write((level), __VA_ARGS__);                            \
+        }                                                                \
+    } while (false)
+
+#define PACMAN_LOG_DEBUG(...) PACMAN_LOG(LogLevel::Debug, __VA_ARGS__)
+#define PACMAN_LOG_INFO(...) PACMAN_LOG(LogLevel::Info, __VA_ARGS__)
+#define PACMAN_LOG_WARN(...) PACMAN_LOG(LogLevel::Warning, __VA_ARGS__)
+#define PACMAN_LOG_ERROR(...) PACMAN_LOG(LogLevel::Error, __VA_ARGS__)
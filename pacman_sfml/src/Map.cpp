@@ -1,42 +1,58 @@
 #include "Map.h"
 
 #include "Direction.h"
+#include "Log.h"
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <cctype>
 #include <fstream>
-#include <iostream>
+#include <iterator>
 #include <vector>
 
+namespace {
+std::uint32_t nextLayoutRevision() {
+    static std::atomic<std::uint32_t> counter{0};
+    return ++counter;
+}
+}
+
 bool Map::loadFromFile(const std::string& path) {
-    std::ifstream in(path);
+    std::ifstream in(path, std::ios::binary);
     if (!in) {
-        std::cerr << "Failed to open map: " << path << "\n";
+        PACMAN_LOG_ERROR("Failed to open map: %s", path.c_str());
         return false;
     }
+    const std::string text((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    return loadFromMemory(text, path);
+}
 
+bool Map::loadFromMemory(std::string_view text, const std::string& path) {
     mGrid.clear();
-    std::string line;
-    while (std::getline(in, line)) {
+    while (!text.empty()) {
+        const std::size_t end = text.find('\n');
+        std::string_view line = text.substr(0, end);
+        text.remove_prefix(end == std::string_view::npos ? text.size() : end + 1);
         // Keep spaces, ignore empty lines at file end.
         if (!line.empty() && (line.back() == '\r')) {
-            line.pop_back();
+            line.remove_suffix(1);
         }
         if (!line.empty()) {
-            mGrid.push_back(line);
+            mGrid.emplace_back(line);
         }
     }
 
     if (mGrid.empty()) {
-        std::cerr << "Map is empty: " << path << "\n";
+        PACMAN_LOG_ERROR("Map is empty: %s", path.c_str());
         return false;
     }
 
     normalizeToRectangle();
+    ++mCellRevision;
 
     if (mWidth != 28 || mHeight != 31) {
-        std::cerr << "Warning: expected 28x31 map, got " << mWidth << "x" << mHeight << " (" << path << ")\n";
+        PACMAN_LOG_WARN("Expected 28x31 map, got %dx%d (%s)", mWidth, mHeight, path.c_str());
     }
 
     mWarps.clear();
@@ -90,7 +106,7 @@ bool Map::loadFromFile(const std::string& path) {
         }
         if (warpPoints[i].size() != 2) {
             const char id = static_cast<char>('a' + static_cast<int>(i));
-            std::cerr << "Warp marker '" << id << "' must appear exactly twice (found " << warpPoints[i].size() << ")\n";
+            PACMAN_LOG_WARN("Warp marker '%c' must appear exactly twice (found %zu)", id, warpPoints[i].size());
             continue;
         }
 
@@ -104,6 +120,32 @@ bool Map::loadFromFile(const std::string& path) {
         }
     }
 
+    mInitialGrid = mGrid;
+
+    // Reloading the same layout (new game, next level) keeps the revision and the nav table.
+    std::string layoutKey = std::to_string(mWidth) + "x" + std::to_string(mHeight) + ":";
+    for (const auto& row : mGrid) {
+        for (char c : row) {
+            layoutKey.push_back(c == '#' ? '#' : ' ');
+        }
+    }
+    for (const auto& w : mWarps) {
+        layoutKey += std::to_string(w.left.x) + "," + std::to_string(w.left.y) + "," + std::to_string(w.right.x) + "," + std::to_string(w.right.y) + ";";
+    }
+
+    if (layoutKey == mLayoutKey && mLayoutRevision != 0) {
+        return true;
+    }
+    mLayoutKey = std::move(layoutKey);
+    mLayoutRevision = nextLayoutRevision();
+
+    auto nav = std::make_shared<NavTable>();
+    if (nav->build(*this)) {
+        mNav = std::move(nav);
+    } else {
+        mNav.reset();
+    }
+
     return true;
 }
 
@@ -121,6 +163,18 @@ void Map::normalizeToRectangle() {
     }
 }
 
+bool Map::restoreInitialCells() {
+    if (mLayoutKey.empty() || mInitialGrid.size() != mGrid.size()) {
+        return false;
+    }
+    // Rows keep their length, so each assignment reuses the row's buffer.
+    for (std::size_t y = 0; y < mGrid.size(); ++y) {
+        mGrid[y] = mInitialGrid[y];
+    }
+    ++mCellRevision;
+    return true;
+}
+
 char Map::cell(int x, int y) const {
     if (x < 0 || y < 0 || x >= mWidth || y >= mHeight) {
         return '#';
@@ -132,7 +186,18 @@ void Map::setCell(int x, int y, char c) {
     if (x < 0 || y < 0 || x >= mWidth || y >= mHeight) {
         return;
     }
-    mGrid[static_cast<size_t>(y)][static_cast<size_t>(x)] = c;
+
+    char& cur = mGrid[static_cast<size_t>(y)][static_cast<size_t>(x)];
+    if ((cur == '#') != (c == '#')) {
+        // Topology changed; the precomputed paths no longer apply.
+        mNav.reset();
+        mLayoutRevision = nextLayoutRevision();
+        mLayoutKey.clear();
+    }
+    if (cur != c) {
+        ++mCellRevision;
+    }
+    cur = c;
 }
 
 bool Map::isWall(int x, int y) const {
@@ -154,6 +219,38 @@ bool Map::hasDotsOrPellets() const {
     return false;
 }
 
+void Map::writePelletBits(std::uint64_t* dots, std::uint64_t* powerPellets) const {
+    const std::size_t words = (static_cast<std::size_t>(mWidth) * static_cast<std::size_t>(mHeight) + 63) / 64;
+    std::fill(dots, dots + words, 0);
+    std::fill(powerPellets, powerPellets + words, 0);
+
+    std::size_t bit = 0;
+    for (const auto& row : mGrid) {
+        for (char c : row) {
+            if (c == '.') {
+                dots[bit >> 6] |= std::uint64_t{1} << (bit & 63);
+            } else if (c == 'o') {
+                powerPellets[bit >> 6] |= std::uint64_t{1} << (bit & 63);
+            }
+            ++bit;
+        }
+    }
+}
+
+void Map::readPelletBits(const std::uint64_t* dots, const std::uint64_t* powerPellets) {
+    ++mCellRevision;
+    std::size_t bit = 0;
+    for (auto& row : mGrid) {
+        for (char& c : row) {
+            if (c == '.' || c == 'o' || c == ' ') {
+                const std::uint64_t mask = std::uint64_t{1} << (bit & 63);
+                c = (dots[bit >> 6] & mask) ? '.' : (powerPellets[bit >> 6] & mask) ? 'o' : ' ';
+            }
+            ++bit;
+        }
+    }
+}
+
 sf::Vector2f Map::tileCenterWorld(TileCoord t, float tileSize) const {
     return {(t.x + 0.5f) * tileSize, (t.y + 0.5f) * tileSize};
 }
@@ -1,13 +1,24 @@
 #pragma once
 
+#include "NavTable.h"
 #include "Types.h"
 #include <SFML/System/Vector2.hpp>
+#include <cstdint>
+#include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 
 class Map {
 public:
+
     bool loadFromFile(const std::string& path);
+    // Same, from map text already in memory (an AssetPack entry); `path` names it in messages.
+    bool loadFromMemory(std::string_view text, const std::string& path);
+
+    // Puts every cell back the way loadFromFile() left it (all pellets present) without
+    // touching the file or the heap. False when walls were edited since; reload the file then.
+    bool restoreInitialCells();
 
     int width() const { return mWidth; }
     int height() const { return mHeight; }
@@ -20,6 +31,11 @@ public:
 
     bool hasDotsOrPellets() const;
 
+    // Pellet layer as row-major bitsets of width()*height() bits (callers size the arrays).
+    // Reading back only touches tiles that hold a pellet or are empty floor.
+    void writePelletBits(std::uint64_t* dots, std::uint64_t* powerPellets) const;
+    void readPelletBits(const std::uint64_t* dots, const std::uint64_t* powerPellets);
+
     TileCoord playerSpawn() const { return mPlayerSpawn; }
     TileCoord ghostSpawnBlinky() const { return mGhostSpawnBlinky; }
     TileCoord ghostSpawnPinky() const { return mGhostSpawnPinky; }
@@ -37,6 +53,15 @@ public:
     bool tryWarp(TileCoord from, Direction dir, TileCoord& out) const;
     TileCoord nextTile(TileCoord from, Direction dir) const;
 
+    // Precomputed all-pairs navigation for the loaded layout; null when the maze is too
+    // large for a table or a wall has been edited since loading.
+    const NavTable* navTable() const { return mNav.get(); }
+
+    // Changes whenever walls change (new file loaded or a wall edited); unique across maps.
+    std::uint32_t layoutRevision() const { return mLayoutRevision; }
+    // Changes whenever any cell changes (pellet eaten, level reloaded, snapshot restored).
+    std::uint32_t cellRevision() const { return mCellRevision; }
+
 private:
     struct Warp {
         char id = 0;
@@ -47,11 +72,19 @@ private:
     void normalizeToRectangle();
 
     std::vector<std::string> mGrid;
+    std::vector<std::string> mInitialGrid;
     int mWidth = 0;
     int mHeight = 0;
 
     std::vector<Warp> mWarps;
 
+    // Shared so copies of the same layout (pacman_batch hands each worker one) reuse one table.
+    std::shared_ptr<const NavTable> mNav;
+    std::uint32_t mLayoutRevision = 0;
+    std::uint32_t mCellRevision = 0;
+    // Walls + warps of the loaded file, used to detect identical reloads.
+    std::string mLayoutKey;
+
     TileCoord mPlayerSpawn{1, 1};
     TileCoord mGhostSpawnBlinky{1, 1};
     TileCoord mGhostSpawnPinky{1, 1};
@@ -0,0 +1,121 @@
+#include "NavTable.h"
+
+#include "Map.h"
+
+#include <array>
+
+namespace {
+constexpr std::uint16_t Unreachable = 0xFFFF;
+
+// Ghost tie-break order; the 2-bit move field indexes this table.
+constexpr Direction MoveOrder[4] = {Direction::Up, Direction::Left, Direction::Down, Direction::Right};
+}
+
+bool NavTable::build(const Map& map) {
+    mWidth = map.width();
+    mHeight = map.height();
+    mCount = 0;
+    mIndex.assign(static_cast<std::size_t>(mWidth * mHeight), -1);
+    mEntries.clear();
+
+    std::vector<TileCoord> tiles;
+    for (int y = 0; y < mHeight; ++y) {
+        for (int x = 0; x < mWidth; ++x) {
+            if (map.isWalkable(x, y)) {
+                mIndex[static_cast<std::size_t>(y * mWidth + x)] = static_cast<std::int32_t>(tiles.size());
+                tiles.push_back({x, y});
+            }
+        }
+    }
+
+    if (tiles.empty() || static_cast<int>(tiles.size()) > MaxTiles) {
+        mIndex.clear();
+        return false;
+    }
+
+    const int count = static_cast<int>(tiles.size());
+
+    // Dense adjacency in MoveOrder, resolved once through Map::nextTile so warps are honoured.
+    std::vector<std::array<std::int32_t, 4>> adjacency(tiles.size());
+    for (int i = 0; i < count; ++i) {
+        for (int m = 0; m < 4; ++m) {
+            const TileCoord to = map.nextTile(tiles[static_cast<std::size_t>(i)], MoveOrder[m]);
+            adjacency[static_cast<std::size_t>(i)][static_cast<std::size_t>(m)] = denseIndex(to);
+        }
+    }
+
+    mEntries.assign(static_cast<std::size_t>(count) * static_cast<std::size_t>(count), Unreachable);
+
+    std::vector<std::int32_t> queue(tiles.size());
+    for (int src = 0; src < count; ++src) {
+        std::uint16_t* row = &mEntries[static_cast<std::size_t>(src) * static_cast<std::size_t>(count)];
+        row[src] = 0;
+
+        // Neighbours are seeded in MoveOrder and each tile inherits the move of the tile that
+        // discovered it, so the first discovery carries the preferred first move.
+        int head = 0;
+        int tail = 0;
+        for (int m = 0; m < 4; ++m) {
+            const std::int32_t n = adjacency[static_cast<std::size_t>(src)][static_cast<std::size_t>(m)];
+            if (n < 0 || row[n] != Unreachable) {
+                continue;
+            }
+            row[n] = static_cast<std::uint16_t>((1 << 2) | m);
+            queue[static_cast<std::size_t>(tail++)] = n;
+        }
+
+        while (head < tail) {
+            const std::int32_t cur = queue[static_cast<std::size_t>(head++)];
+            const std::uint16_t entry = row[cur];
+            const std::uint16_t next = static_cast<std::uint16_t>(entry + (1 << 2));
+
+            for (std::int32_t n : adjacency[static_cast<std::size_t>(cur)]) {
+                if (n < 0 || row[n] != Unreachable) {
+                    continue;
+                }
+                row[n] = next;
+                queue[static_cast<std::size_t>(tail++)] = n;
+            }
+        }
+    }
+
+    mCount = count;
+    return true;
+}
+
+int NavTable::denseIndex(TileCoord t) const {
+    if (t.x < 0 || t.y < 0 || t.x >= mWidth || t.y >= mHeight) {
+        return -1;
+    }
+    return mIndex[static_cast<std::size_t>(t.y * mWidth + t.x)];
+}
+
+int NavTable::distance(TileCoord from, TileCoord to) const {
+    if (from == to) {
+        return 0;
+    }
+
+    const int a = denseIndex(from);
+    const int b = denseIndex(to);
+    if (a < 0 || b < 0) {
+        return -1;
+    }
+
+    const std::uint16_t entry = mEntries[static_cast<std::size_t>(a) * static_cast<std::size_t>(mCount) + static_cast<std::size_t>(b)];
+    return (entry == Unreachable) ? -1 : (entry >> 2);
+}
+
+Direction NavTable::firstMove(TileCoord from, TileCoord to) const {
+    if (from == to) {
+        return Direction::None;
+    }
+
+    const int a = denseIndex(from);
+    const int b = denseIndex(to);
+    if (a < 0 || b < 0) {
+        return Direction::None;
+    }
+
+    const std::uint16_t entry = mEntries[static_cast<std::size_t>(a) * static_cast<std::size_t>(mCount) + static_cast<std::size_t>(b)];
+    return (entry == Unreachable) ? Direction::None : MoveOrder[entry & 3u];
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "Types.h"
+
+#include <cstdint>
+#include <vector>
+
+class Map;
+
+// All-pairs shortest paths over the walkable tiles of a static maze, warp tunnels included.
+// Each (from, to) entry packs the BFS distance and the first move of a shortest path, so a
+// ghost decision is a constant-time lookup instead of a BFS per candidate direction.
+class NavTable {
+public:
+    // Larger mazes skip the table (N^2 entries) and fall back to on-demand searches.
+    static constexpr int MaxTiles = 2048;
+
+    // Returns false and leaves the table empty if the map has more than MaxTiles walkable tiles.
+    bool build(const Map& map);
+
+    bool empty() const { return mCount == 0; }
+    int tileCount() const { return mCount; }
+
+    // Same contract as a BFS from `from`: 0 when from == to, -1 when either tile is not
+    // walkable or `to` cannot be reached.
+    int distance(TileCoord from, TileCoord to) const;
+
+    // First step of the shortest path, ties broken Up, Left, Down, Right (the ghost preference).
+    // Direction::None when from == to or no path exists.
+    Direction firstMove(TileCoord from, TileCoord to) const;
+
+private:
+    int denseIndex(TileCoord t) const;
+
+    int mWidth = 0;
+    int mHeight = 0;
+    int mCount = 0;
+
+    // Tile -> dense walkable index (-1 for walls).
+    std::vector<std::int32_t> mIndex;
+    // mCount x mCount entries: (distance << 2) | move, or Unreachable.
+    std::vector<std::uint16_t> mEntries;
+};
@@ -2,6 +2,7 @@
 
 #include "Direction.h"
 #include "Map.h"
+#include "Profiler.h"
 
 #include <algorithm>
 #include <cmath>
@@ -9,15 +10,15 @@
 
 
 void Player::reset(TileCoord spawn, const Map& map, float tileSize) {
-    mPos = map.tileCenterWorld(spawn, tileSize);
+    mMover.reset(spawn, map, tileSize);
     mDir = Direction::Left;
     mRequestedDirection = Direction::Left;
     mMouthPhase = 0.f;
     mMouthOpen01 = 1.f;
 }
 
-TileCoord Player::currentTile(const Map& map, float tileSize) const {
-    return map.worldToTile(mPos, tileSize);
+TileCoord Player::currentTile(const Map& map, float /*tileSize*/) const {
+    return mMover.tile(map);
 }
 
 bool Player::canStep(Direction d, TileCoord from, const Map& map) const {
@@ -30,17 +31,11 @@ bool Player::canStep(Direction d, TileCoord from, const Map& map) const {
 }
 
 void Player::update(float dt, const Map& map, float tileSize) {
+    PACMAN_ZONE("Player::update");
     const TileCoord tile = currentTile(map, tileSize);
-    const sf::Vector2f center = map.tileCenterWorld(tile, tileSize);
-    const sf::Vector2f delta = {mPos.x - center.x, mPos.y - center.y};
-
-    const float epsilon = tileSize * 0.10f;
-    const bool nearCenter = (std::abs(delta.x) < epsilon) && (std::abs(delta.y) < epsilon);
+    const bool nearCenter = mMover.snapToCenter(tile, map);
 
     if (nearCenter) {
-        // Snap to center to avoid drift.
-        mPos = center;
-
         if (canStep(mRequestedDirection, tile, map)) {
             mDir = mRequestedDirection;
         }
@@ -52,27 +47,11 @@ void Player::update(float dt, const Map& map, float tileSize) {
         // Apply tunnel warp only from explicit endpoints.
         TileCoord warped;
         if (map.tryWarp(tile, mDir, warped)) {
-            mPos = map.tileCenterWorld(warped, tileSize);
+            mMover.placeAt(warped, map);
         }
     }
 
-    const sf::Vector2f dir = dirToUnitVector(mDir);
-    const float speed = mSpeedTilesPerSecond * tileSize;
-
-    // Probe slightly ahead to simulate a smaller hitbox against walls.
-    const float probe = tileSize * 0.20f;
-    sf::Vector2f newPos = mPos;
-    newPos.x += dir.x * speed * dt;
-    newPos.y += dir.y * speed * dt;
-    const sf::Vector2f probePos{newPos.x + dir.x * probe, newPos.y + dir.y * probe};
-    const TileCoord newTile = map.worldToTile(probePos, tileSize);
-
-    if (map.isWalkable(newTile.x, newTile.y)) {
-        mPos = newPos;
-    } else if (nearCenter) {
-        mPos = center;
-        mDir = Direction::None;
-    }
+    mMover.advance(mDir, mSpeedTilesPerSecond, dt, map, tile, nearCenter);
 
     // Simple mouth animation, faster while moving.
     const float moveFactor = (mDir == Direction::None) ? 0.5f : 1.0f;
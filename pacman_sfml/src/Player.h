@@ -1,5 +1,6 @@
 #pragma once
 
+#include "GridMover.h"
 #include "Types.h"
 #include <SFML/System/Vector2.hpp>
 
@@ -10,9 +11,11 @@ public:
     void reset(TileCoord spawn, const Map& map, float tileSize);
 
     void requestDirection(Direction d) { mRequestedDirection = d; }
+    Direction requestedDirection() const { return mRequestedDirection; }
     void update(float dt, const Map& map, float tileSize);
 
-    sf::Vector2f position() const { return mPos; }
+    sf::Vector2f position() const { return mMover.position(); }
+    const GridMover& mover() const { return mMover; }
     Direction direction() const { return mDir; }
 
     float radius(float tileSize) const { return tileSize * 0.42f; }
@@ -23,7 +26,7 @@ public:
 private:
     bool canStep(Direction d, TileCoord from, const Map& map) const;
 
-    sf::Vector2f mPos{0.f, 0.f};
+    GridMover mMover;
     Direction mDir = Direction::Left;
     Direction mRequestedDirection = Direction::Left;
 
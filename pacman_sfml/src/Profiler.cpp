@@ -0,0 +1,153 @@
+#include "Profiler.h"
+
+#include "Log.h"
+
+#if PACMAN_PROFILE
+
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace {
+constexpr std::size_t RingSize = std::size_t{1} << 16;
+// Zones this close to the write position may be overwritten while an export reads them; skip them.
+constexpr std::size_t ExportSlack = 1024;
+
+// Relaxed atomics: plain stores on x86/ARM, but an export from another thread stays race-free.
+struct ZoneRecord {
+    std::atomic<const char*> name{nullptr};
+    std::atomic<std::uint64_t> start{0};
+    std::atomic<std::uint64_t> end{0};
+};
+
+struct ThreadRing {
+    std::uint32_t id = 0;
+    std::string name; // guarded by gRegistryMutex
+    std::unique_ptr<ZoneRecord[]> zones{new ZoneRecord[RingSize]};
+    std::atomic<std::uint64_t> written{0};
+};
+
+std::mutex gRegistryMutex;
+// Rings outlive their threads so zones from finished threads still export.
+std::vector<std::shared_ptr<ThreadRing>> gRings;
+
+std::shared_ptr<ThreadRing> registerThread() {
+    auto ring = std::make_shared<ThreadRing>();
+    std::lock_guard<std::mutex> lock(gRegistryMutex);
+    ring->id = static_cast<std::uint32_t>(gRings.size() + 1);
+    ring->name = "thread " + std::to_string(ring->id);
+    gRings.push_back(ring);
+    return ring;
+}
+
+ThreadRing& localRing() {
+    thread_local const std::shared_ptr<ThreadRing> ring = registerThread();
+    return *ring;
+}
+
+void writeJsonString(std::ostream& out, const char* s) {
+    out << '"';
+    for (; *s != '\0'; ++s) {
+        if (*s == '"' || *s == '\\') {
+            out << '\\';
+        }
+        out << *s;
+    }
+    out << '"';
+}
+}
+
+void Profiler::setThreadName(const std::string& name) {
+    ThreadRing& ring = localRing();
+    std::lock_guard<std::mutex> lock(gRegistryMutex);
+    ring.name = name;
+}
+
+void Profiler::record(const char* name, std::uint64_t startNanos, std::uint64_t endNanos) {
+    ThreadRing& ring = localRing();
+    const std::uint64_t index = ring.written.load(std::memory_order_relaxed);
+    ZoneRecord& z = ring.zones[index & (RingSize - 1)];
+    z.name.store(name, std::memory_order_relaxed);
+    z.start.store(startNanos, std::memory_order_relaxed);
+    z.end.store(endNanos, std::memory_order_relaxed);
+    ring.written.store(index + 1, std::memory_order_release);
+}
+
+bool Profiler::writeChromeTrace(const std::string& path) {
+    std::ofstream out(path, std::ios::trunc);
+    if (!out) {
+        PACMAN_LOG_ERROR("Failed to open trace file: %s", path.c_str());
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(gRegistryMutex);
+
+    // Chrome wants microseconds; start the timeline at the oldest exported zone.
+    std::uint64_t origin = std::numeric_limits<std::uint64_t>::max();
+    for (const auto& ring : gRings) {
+        const std::uint64_t written = ring->written.load(std::memory_order_acquire);
+        const std::uint64_t first = written > RingSize - ExportSlack ? written - (RingSize - ExportSlack) : 0;
+        if (first < written) {
+            origin = std::min(origin, ring->zones[first & (RingSize - 1)].start.load(std::memory_order_relaxed));
+        }
+    }
+    if (origin == std::numeric_limits<std::uint64_t>::max()) {
+        origin = 0;
+    }
+
+    out << "{\"traceEvents\":[\n";
+    bool firstEvent = true;
+    auto separator = [&] {
+        out << (firstEvent ? "" : ",\n");
+        firstEvent = false;
+    };
+
+    for (const auto& ring : gRings) {
+        separator();
+        out << "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":" << ring->id << ",\"args\":{\"name\":";
+        writeJsonString(out, ring->name.c_str());
+        out << "}}";
+
+        const std::uint64_t written = ring->written.load(std::memory_order_acquire);
+        const std::uint64_t first = written > RingSize - ExportSlack ? written - (RingSize - ExportSlack) : 0;
+        for (std::uint64_t i = first; i < written; ++i) {
+            const ZoneRecord& z = ring->zones[i & (RingSize - 1)];
+            const char* name = z.name.load(std::memory_order_relaxed);
+            const std::uint64_t start = z.start.load(std::memory_order_relaxed);
+            const std::uint64_t end = z.end.load(std::memory_order_relaxed);
+            if (name == nullptr || start < origin || end < start) {
+                continue;
+            }
+
+            separator();
+            out << "{\"ph\":\"X\",\"pid\":1,\"tid\":" << ring->id << ",\"name\":";
+            writeJsonString(out, name);
+            out << ",\"ts\":" << static_cast<double>(start - origin) / 1000.0
+                << ",\"dur\":" << static_cast<double>(end - start) / 1000.0 << "}";
+        }
+    }
+    out << "\n]}\n";
+
+    if (!out) {
+        PACMAN_LOG_ERROR("Failed to write trace file: %s", path.c_str());
+        return false;
+    }
+    return true;
+}
+
+#else
+
+void Profiler::setThreadName(const std::string&) {}
+
+void Profiler::record(const char*, std::uint64_t, std::uint64_t) {}
+
+bool Profiler::writeChromeTrace(const std::string& path) {
+    PACMAN_LOG_ERROR("Cannot write %s: built without PACMAN_PROFILE", path.c_str());
+    return false;
+}
+
+#endif
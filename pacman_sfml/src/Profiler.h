@@ -0,0 +1,54 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#ifndef PACMAN_PROFILE
+#define PACMAN_PROFILE 0
+#endif
+
+// Scoped-zone profiler. PACMAN_ZONE("Name") times the rest of the enclosing block. Names must
+// be string literals: only the pointer is stored. Each thread records into its own fixed ring
+// holding its newest zones, so recording takes no lock and, after the thread's first zone,
+// never allocates. In builds without PACMAN_PROFILE the macro expands to nothing.
+class Profiler {
+public:
+    static constexpr bool Enabled = PACMAN_PROFILE != 0;
+
+    // Label for the calling thread in exported traces.
+    static void setThreadName(const std::string& name);
+
+    // Every thread's recorded zones as Chrome trace-event JSON (chrome://tracing, Perfetto).
+    // False when the file cannot be written or the build has no profiler.
+    static bool writeChromeTrace(const std::string& path);
+
+    static std::uint64_t nowNanos() {
+        return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    static void record(const char* name, std::uint64_t startNanos, std::uint64_t endNanos);
+};
+
+#if PACMAN_PROFILE
+class ProfileZone {
+public:
+    explicit ProfileZone(const char* name) : mName(name), mStart(Profiler::nowNanos()) {}
+    ~ProfileZone() { Profiler::record(mName, mStart, Profiler::nowNanos()); }
+
+    ProfileZone(const ProfileZone&) = delete;
+    ProfileZone& operator=(const ProfileZone&) = delete;
+
+private:
+    const char* mName;
+    std::uint64_t mStart;
+};
+
+#define PACMAN_ZONE_CONCAT_INNER(a, b) a##b
+#define PACMAN_ZONE_CONCAT(a, b) PACMAN_ZONE_CONCAT_INNER(a, b)
+// The "" prefix rejects anything but a string literal at compile time.
+#define PACMAN_ZONE(name) ProfileZone PACMAN_ZONE_CONCAT(pacmanZone, __LINE__)("" name)
+#else
+#define PACMAN_ZONE(name) static_cast<void>(0)
+#endif
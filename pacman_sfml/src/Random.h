@@ -0,0 +1,11 @@
+#pragma once
+
+#include <cstddef>
+#include <random>
+
+// Uniform-ish index in [0, count) from a seeded engine. std::mt19937's output is fully specified
+// by the standard but std::uniform_int_distribution is not, so libstdc++, libc++ and MSVC would
+// pick differently from the same seed. The modulo bias is negligible for the tiny counts used.
+inline std::size_t pickIndex(std::mt19937& rng, std::size_t count) {
+    return static_cast<std::size_t>(rng() % count);
+}
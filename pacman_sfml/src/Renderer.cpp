@@ -2,8 +2,10 @@
 
 #include "Ghost.h"
 #include "Map.h"
+#include "Log.h"
 #include "Menu.h"
 #include "Player.h"
+#include "Profiler.h"
 
 #include <SFML/Graphics/CircleShape.hpp>
 #include <SFML/Graphics/ConvexShape.hpp>
@@ -13,82 +15,148 @@
 
 #include <algorithm>
 #include <cmath>
-#include <iostream>
+#include <cstdio>
+
+namespace {
+sf::Color ghostColor(const Ghost& ghost) {
+    if (ghost.mode() == GhostMode::Frightened) {
+        return sf::Color(60, 60, 255);
+    }
+    if (ghost.mode() == GhostMode::Eaten) {
+        return sf::Color(220, 220, 255);
+    }
+
+    switch (ghost.id()) {
+    case GhostId::Blinky: return sf::Color(255, 60, 60);
+    case GhostId::Pinky: return sf::Color(255, 140, 200);
+    case GhostId::Inky: return sf::Color(60, 230, 230);
+    case GhostId::Clyde: return sf::Color(255, 170, 40);
+    }
+    return sf::Color(255, 60, 60);
+}
+}
 
 Renderer::Renderer(sf::RenderWindow& window) : mWindow(window) {
     if (!mNative.create(static_cast<unsigned>(mNativeWidth), static_cast<unsigned>(mNativeHeight))) {
-        std::cerr << "Failed to create native render target\n";
+        PACMAN_LOG_ERROR("Failed to create native render target");
+    }
+
+    mMazeLayerReady = mMazeLayer.create(static_cast<unsigned>(mNativeWidth), static_cast<unsigned>(mNativeHeight - mHudHeight));
+    if (!mMazeLayerReady) {
+        PACMAN_LOG_ERROR("Failed to create maze layer; drawing walls directly");
     }
+
+    // Untextured fallback quads (missing coin images) sample this texel and use vertex colors.
+    sf::Image white;
+    white.create(1, 1, sf::Color::White);
+    mWhiteFrame = mAtlas.addImage("__white", white);
+    mAtlas.pack();
+
+    mBitmapFont.bake();
+
+    const float width = static_cast<float>(mNativeWidth);
+    const float height = static_cast<float>(mNativeHeight);
+    mHudStrip.setSize({width, static_cast<float>(mHudHeight)});
+    mHudStrip.setFillColor(sf::Color(10, 10, 10));
+    mDimShape.setSize({width, height});
+    mMenuFrame.setSize({width - 14.f, height - 14.f});
+    mMenuFrame.setPosition(7.f, 7.f);
+    mMenuFrame.setFillColor(sf::Color(0, 0, 0, 0));
+    mMenuFrame.setOutlineColor(sf::Color(50, 184, 198));
+    mMenuFrame.setOutlineThickness(2.f);
+    mLoadingBar.setFillColor(sf::Color(255, 196, 80));
+    mFruitShape.setFillColor(sf::Color(255, 60, 200));
+    mPlayerBody.setFillColor(sf::Color(255, 230, 40));
+    mPlayerMouth.setFillColor(sf::Color::Black);
+    mGhostEyeWhite.setFillColor(sf::Color::White);
+    mGhostPupil.setFillColor(sf::Color::Blue);
 }
 
 bool Renderer::loadFont(const std::string& path) {
     if (!mFont.loadFromFile(path)) {
-        std::cerr << "Failed to load font: " << path << "\n";
+        PACMAN_LOG_ERROR("Failed to load font: %s", path.c_str());
         mHasFont = false;
+        mHudDirty = true;
         return false;
     }
     mHasFont = true;
+    mHudDirty = true;
     return true;
 }
 
-bool Renderer::loadAtlas(const std::string& imagePath, const std::string& jsonPath) {
-    mHasAtlas = mAtlas.loadFromFiles(imagePath, jsonPath);
+bool Renderer::loadFontFromMemory(const void* data, std::size_t size) {
+    mHasFont = mFont.loadFromMemory(data, size);
+    mHudDirty = true;
+    if (!mHasFont) {
+        PACMAN_LOG_ERROR("Failed to load font from memory");
+    }
+    return mHasFont;
+}
+
+bool Renderer::setAtlasFrames(const std::vector<SpriteAtlas::Frame>& frames) {
+    mHasAtlas = mAtlas.addFrames(frames);
+
+    mPacmanOpenFrame = mAtlas.find(AtlasFrame::PacmanOpen);
+    mPacmanClosedFrame = mAtlas.find(AtlasFrame::PacmanClosed);
+    mGhostFrames[static_cast<std::size_t>(GhostId::Blinky)] = mAtlas.find(AtlasFrame::GhostRed);
+    mGhostFrames[static_cast<std::size_t>(GhostId::Pinky)] = mAtlas.find(AtlasFrame::GhostPink);
+    mGhostFrames[static_cast<std::size_t>(GhostId::Inky)] = mAtlas.find(AtlasFrame::GhostCyan);
+    mGhostFrames[static_cast<std::size_t>(GhostId::Clyde)] = mAtlas.find(AtlasFrame::GhostOrange);
+    mGhostFrightFrame = mAtlas.find(AtlasFrame::GhostFright);
+    mGhostEatenFrame = mAtlas.find(AtlasFrame::GhostEaten);
+
+    mMazeLayerDirty = true;
+    mPelletLayerDirty = true;
+    mHudDirty = true;
     return mHasAtlas;
 }
 
-bool Renderer::loadBackground(const std::string& path) {
-    if (!mBackgroundTexture.loadFromFile(path)) {
-        std::cerr << "Failed to load background: " << path << "\n";
+bool Renderer::setBackground(const sf::Image& image) {
+    if (!mBackgroundTexture.loadFromImage(image)) {
+        PACMAN_LOG_ERROR("Failed to create background texture");
         mHasBackground = false;
         return false;
     }
 
     mBackgroundTexture.setSmooth(true);
-    mBackgroundSprite.setTexture(mBackgroundTexture);
+    mBackgroundSprite.setTexture(mBackgroundTexture, true);
     mHasBackground = true;
+    mMazeLayerDirty = true;
     return true;
 }
 
-bool Renderer::loadMapSprites(const std::string& tilePath, const std::string& smallDotPath, const std::string& bigDotPath) {
-    mHasTileTexture = mTileTexture.loadFromFile(tilePath);
-    mHasMiniCoinTexture = mMiniCoinTexture.loadFromFile(smallDotPath);
-    mHasBigCoinTexture = mBigCoinTexture.loadFromFile(bigDotPath);
-
-    if (!mHasTileTexture) {
-        std::cerr << "Failed to load tile texture: " << tilePath << "\n";
+bool Renderer::addAtlasImage(AtlasImage which, const sf::Image& image) {
+    switch (which) {
+    case AtlasImage::Tile:
+        mTileFrame = mAtlas.addImage("tile", image);
+        break;
+    case AtlasImage::Dot:
+        mDotFrame = mAtlas.addImage("dot", image);
+        break;
+    case AtlasImage::PowerPellet:
+        mPowerFrame = mAtlas.addImage("power_pellet", image);
+        break;
+    case AtlasImage::Heart: {
+        sf::Image keyed = image;
+        keyed.createMaskFromColor(sf::Color::Black);
+        mHeartFrame = mAtlas.addImage("heart", keyed);
+        break;
     }
-    if (!mHasMiniCoinTexture) {
-        std::cerr << "Failed to load small dot texture: " << smallDotPath << "\n";
     }
-    if (!mHasBigCoinTexture) {
-        std::cerr << "Failed to load big dot texture: " << bigDotPath << "\n";
-    }
-
-    mTileTexture.setSmooth(false);
-    mMiniCoinTexture.setSmooth(false);
-    mBigCoinTexture.setSmooth(false);
-
-    return mHasTileTexture && mHasMiniCoinTexture && mHasBigCoinTexture;
+    return repackAtlas();
 }
 
-bool Renderer::loadHeartTexture(const std::string& path) {
-    sf::Image img;
-    if (!img.loadFromFile(path)) {
-        std::cerr << "Failed to load heart texture: " << path << "\n";
-        mHasHeartTexture = false;
-        return false;
+bool Renderer::repackAtlas() {
+    // Packing moves frames around; cached quads must pick up the new texture coordinates.
+    mMazeLayerDirty = true;
+    mPelletLayerDirty = true;
+    mHudDirty = true;
+    if (mAtlas.pack()) {
+        return true;
     }
-    img.createMaskFromColor(sf::Color::Black);
 
-    if (!mHeartTexture.loadFromImage(img)) {
-        std::cerr << "Failed to create heart texture from image: " << path << "\n";
-        mHasHeartTexture = false;
-        return false;
-    }
-
-    mHeartTexture.setSmooth(false);
-    mHasHeartTexture = true;
-    return true;
+    mHasAtlas = false;
+    return false;
 }
 
 void Renderer::handleResize() {
@@ -102,21 +170,173 @@ sf::Vector2f Renderer::playfieldOffset(const Map& map, float tileSize) const {
     return {x, y};
 }
 
+void Renderer::setInterpolationAlpha(float alpha) {
+    mAlpha = std::clamp(alpha, 0.f, 1.f);
+}
+
+sf::Vector2f Renderer::interpolate(sf::Vector2f previous, sf::Vector2f current, float tileSize) const {
+    // Nothing moves a tile in one tick, so a bigger jump is a tunnel warp or a respawn: snap.
+    const sf::Vector2f delta = current - previous;
+    if (std::abs(delta.x) > tileSize || std::abs(delta.y) > tileSize) {
+        return current;
+    }
+    return previous + delta * mAlpha;
+}
+
 void Renderer::beginFrame() {
+    const auto now = std::chrono::steady_clock::now();
+    if (mFrameStart != std::chrono::steady_clock::time_point{}) {
+        mLastFrameMs = std::chrono::duration<float, std::milli>(now - mFrameStart).count();
+        mFrameTimes[mFrameTimeHead] = mLastFrameMs;
+        mFrameTimeHead = (mFrameTimeHead + 1) % PerfHistory;
+    }
+    mFrameStart = now;
+    mFrameCounters = FrameCounters{};
+
     mNative.clear(sf::Color::Black);
 
     // HUD strip background
-    sf::RectangleShape hud({static_cast<float>(mNativeWidth), static_cast<float>(mHudHeight)});
-    hud.setPosition(0.f, 0.f);
-    hud.setFillColor(sf::Color(10, 10, 10));
-    mNative.draw(hud);
+    submit(mHudStrip);
 }
 
 void Renderer::endFrame() {
+    flushSprites();
+    mLastCounters = mFrameCounters;
+    if (mPerfOverlayVisible) {
+        drawPerfOverlay();
+    }
     presentToWindow();
 }
 
+void Renderer::setSimFrameStats(int ticks, float simMs) {
+    mSimTicks = ticks;
+    mSimMs = simMs;
+}
+
+void Renderer::setAllocationStats(std::uint32_t simAllocations, std::uint32_t frameAllocations) {
+    mSimAllocations = simAllocations;
+    mFrameAllocations = frameAllocations;
+}
+
+void Renderer::setRetainedText(RetainedText& retained, std::string_view content) {
+    if (retained.content == content) {
+        return;
+    }
+    retained.content.assign(content.data(), content.size());
+    // Refilled a character at a time so the sf::String keeps its buffer.
+    retained.glyphs.clear();
+    for (char c : content) {
+        retained.glyphs += sf::String(static_cast<sf::Uint32>(static_cast<unsigned char>(c)));
+    }
+    retained.text.setString(retained.glyphs);
+}
+
+void Renderer::submit(const sf::VertexArray& vertices, const sf::RenderStates& states) {
+    if (vertices.getVertexCount() == 0) {
+        return;
+    }
+    ++mFrameCounters.drawCalls;
+    mFrameCounters.vertices += static_cast<std::uint32_t>(vertices.getVertexCount());
+    mNative.draw(vertices, states);
+}
+
+void Renderer::submit(const sf::Shape& shape) {
+    // A triangle fan for the fill plus, when outlined, a strip for the outline.
+    const auto points = static_cast<std::uint32_t>(shape.getPointCount());
+    ++mFrameCounters.drawCalls;
+    mFrameCounters.vertices += points + 2;
+    if (shape.getOutlineThickness() != 0.f) {
+        ++mFrameCounters.drawCalls;
+        mFrameCounters.vertices += (points + 1) * 2;
+    }
+    mNative.draw(shape);
+}
+
+void Renderer::submit(const sf::Sprite& sprite) {
+    ++mFrameCounters.drawCalls;
+    mFrameCounters.vertices += 4;
+    mNative.draw(sprite);
+}
+
+void Renderer::submit(const sf::Text& text) {
+    // Two triangles per glyph.
+    ++mFrameCounters.drawCalls;
+    mFrameCounters.vertices += static_cast<std::uint32_t>(text.getString().getSize()) * 6;
+    mNative.draw(text);
+}
+
+void Renderer::submit(const TextMesh& mesh) {
+    if (mesh.vertexCount() == 0) {
+        return;
+    }
+    ++mFrameCounters.drawCalls;
+    mFrameCounters.vertices += static_cast<std::uint32_t>(mesh.vertexCount());
+    mNative.draw(mesh);
+}
+
+void Renderer::drawPerfOverlay() {
+    constexpr float GraphHeight = 32.f;
+    constexpr float GraphFullScaleMs = 100.f / 3.f; // two 60 Hz frames
+    constexpr float TextHeight = 26.f;
+
+    const float width = static_cast<float>(mNativeWidth);
+    const float bottom = static_cast<float>(mNativeHeight);
+    const float top = bottom - GraphHeight - TextHeight;
+
+    auto quad = [this](float x0, float y0, float x1, float y1, sf::Color color) {
+        mPerfPanel.append(sf::Vertex({x0, y0}, color));
+        mPerfPanel.append(sf::Vertex({x1, y0}, color));
+        mPerfPanel.append(sf::Vertex({x1, y1}, color));
+        mPerfPanel.append(sf::Vertex({x0, y1}, color));
+    };
+
+    mPerfPanel.clear();
+    quad(0.f, top, width, bottom, sf::Color(0, 0, 0, 190));
+
+    // Oldest frame on the left; green within one 60 Hz frame, yellow within two, red beyond.
+    const float barWidth = width / static_cast<float>(PerfHistory);
+    for (std::size_t i = 0; i < PerfHistory; ++i) {
+        const float ms = mFrameTimes[(mFrameTimeHead + i) % PerfHistory];
+        const float h = std::min(ms / GraphFullScaleMs, 1.f) * GraphHeight;
+        const sf::Color color = ms <= 17.f ? sf::Color(60, 220, 90) : ms <= 34.f ? sf::Color(240, 200, 40) : sf::Color(240, 60, 60);
+        const float x = static_cast<float>(i) * barWidth;
+        quad(x, bottom - h, x + barWidth, bottom, color);
+    }
+    const float targetY = bottom - GraphHeight * 0.5f;
+    quad(0.f, targetY, width, targetY + 1.f, sf::Color(255, 255, 255, 90));
+
+    // Fixed-size buffers keep the overlay itself allocation-free.
+    char line1[48];
+    char line2[48];
+    char line3[48];
+    std::snprintf(line1, sizeof(line1), "FRAME %5.1fMS SIM %5.2f RND %5.2f", static_cast<double>(mLastFrameMs),
+                  static_cast<double>(mSimMs), static_cast<double>(mLastRenderMs));
+    std::snprintf(line2, sizeof(line2), "TICKS %d DRAWS %u VERTS %u", mSimTicks,
+                  static_cast<unsigned>(mLastCounters.drawCalls), static_cast<unsigned>(mLastCounters.vertices));
+    std::snprintf(line3, sizeof(line3), "ALLOCS SIM %u FRAME %u", static_cast<unsigned>(mSimAllocations),
+                  static_cast<unsigned>(mFrameAllocations));
+
+    mPerfText.clear();
+    const sf::Color textColor(230, 230, 230);
+    mBitmapFont.append(mPerfText, line1, {2.f, top + 2.f}, 1, textColor);
+    mBitmapFont.append(mPerfText, line2, {2.f, top + 10.f}, 1, textColor);
+    mBitmapFont.append(mPerfText, line3, {2.f, top + 18.f}, 1, textColor);
+
+    // Drawn straight to the target so the overlay does not count itself.
+    mNative.draw(mPerfPanel);
+    mNative.draw(mPerfText, sf::RenderStates(&mBitmapFont.texture()));
+}
+
+void Renderer::flushSprites() {
+    if (mSpriteBatch.getVertexCount() == 0) {
+        return;
+    }
+    submit(mSpriteBatch, sf::RenderStates(&mAtlas.texture()));
+    mSpriteBatch.clear();
+}
+
 void Renderer::presentToWindow() {
+    PACMAN_ZONE("Renderer::presentToWindow");
     mNative.display();
 
     const sf::Vector2u win = mWindow.getSize();
@@ -141,370 +361,505 @@ void Renderer::presentToWindow() {
     mWindow.setView(mWindow.getDefaultView());
     mWindow.clear(sf::Color::Black);
     mWindow.draw(mPresent);
+    // CPU cost of the frame, not the wait for vsync in display().
+    mLastRenderMs = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - mFrameStart).count();
     mWindow.display();
 }
 
-void Renderer::drawMap(const Map& map, float tileSize) {
-    const sf::Vector2f off = playfieldOffset(map, tileSize);
-    mCachedPlayfieldOffset = off;
-    mCachedTileSize = tileSize;
-
+void Renderer::drawMazeStatic(sf::RenderTarget& target, const Map& map, float tileSize, sf::Vector2f off, float top) {
     if (mHasBackground) {
         const auto texSize = mBackgroundTexture.getSize();
         if (texSize.x > 0 && texSize.y > 0) {
             const float scaleX = static_cast<float>(mNativeWidth) / static_cast<float>(texSize.x);
             const float scaleY = static_cast<float>(mNativeHeight - mHudHeight) / static_cast<float>(texSize.y);
             mBackgroundSprite.setScale(scaleX, scaleY);
-            mBackgroundSprite.setPosition(0.f, static_cast<float>(mHudHeight));
-            mNative.draw(mBackgroundSprite);
+            mBackgroundSprite.setPosition(0.f, top);
+            target.draw(mBackgroundSprite);
         }
     }
 
     sf::Sprite wallSprite;
-    sf::Sprite dotSprite;
-    sf::Sprite pelletSprite;
-
-    // Ensure no leftover background colors on tiles/coins
-    if (mHasTileTexture) {
-        wallSprite.setTexture(mTileTexture);
-        const auto sz = mTileTexture.getSize();
-        if (sz.x > 0 && sz.y > 0) {
-            const float scaleX = tileSize / static_cast<float>(sz.x);
-            const float scaleY = tileSize / static_cast<float>(sz.y);
+    if (mTileFrame != InvalidSprite) {
+        const sf::IntRect& rect = mAtlas.frameRect(mTileFrame);
+        wallSprite.setTexture(mAtlas.texture());
+        wallSprite.setTextureRect(rect);
+        if (rect.width > 0 && rect.height > 0) {
+            const float scaleX = tileSize / static_cast<float>(rect.width);
+            const float scaleY = tileSize / static_cast<float>(rect.height);
             wallSprite.setScale(scaleX, scaleY);
         }
     }
 
-    if (mHasMiniCoinTexture) {
-        dotSprite.setTexture(mMiniCoinTexture);
-        const auto sz = mMiniCoinTexture.getSize();
-        if (sz.x > 0 && sz.y > 0) {
-            const float scale = (tileSize * 0.5f) / static_cast<float>(sz.x);
-            dotSprite.setScale(scale, scale);
-            dotSprite.setOrigin(static_cast<float>(sz.x) * 0.5f, static_cast<float>(sz.y) * 0.5f);
+    sf::RectangleShape wall({tileSize, tileSize});
+    wall.setFillColor(sf::Color(20, 20, 200));
+
+    for (int y = 0; y < map.height(); ++y) {
+        for (int x = 0; x < map.width(); ++x) {
+            if (map.cell(x, y) != '#') {
+                continue;
+            }
+            const float px = off.x + static_cast<float>(x) * tileSize;
+            const float py = off.y + static_cast<float>(y) * tileSize;
+            if (mTileFrame != InvalidSprite) {
+                wallSprite.setPosition(px, py);
+                target.draw(wallSprite);
+            } else {
+                wall.setPosition(px, py);
+                target.draw(wall);
+            }
         }
     }
+}
 
-    if (mHasBigCoinTexture) {
-        pelletSprite.setTexture(mBigCoinTexture);
-        const auto sz = mBigCoinTexture.getSize();
-        if (sz.x > 0 && sz.y > 0) {
-            const float scale = (tileSize * 0.7f) / static_cast<float>(sz.x);
-            pelletSprite.setScale(scale, scale);
-            pelletSprite.setOrigin(static_cast<float>(sz.x) * 0.5f, static_cast<float>(sz.y) * 0.5f);
+void Renderer::rebuildMazeLayer(const Map& map, float tileSize) {
+    mMazeLayerDirty = false;
+    mMazeLayerRevision = map.layoutRevision();
+    mMazeLayerTileSize = tileSize;
+
+    // Layer space starts at the top of the playfield (below the HUD strip).
+    const float top = static_cast<float>(mHudHeight);
+    const sf::Vector2f off = playfieldOffset(map, tileSize);
+
+    mMazeLayer.clear(sf::Color::Black);
+    drawMazeStatic(mMazeLayer, map, tileSize, {off.x, off.y - top}, 0.f);
+    mMazeLayer.display();
+
+    mMazeLayerSprite.setTexture(mMazeLayer.getTexture(), true);
+    mMazeLayerSprite.setPosition(0.f, top);
+}
+
+void Renderer::drawMap(const Map& map, float tileSize) {
+    PACMAN_ZONE("Renderer::drawMap");
+    const sf::Vector2f off = playfieldOffset(map, tileSize);
+    mCachedPlayfieldOffset = off;
+    mCachedTileSize = tileSize;
+
+    if (mMazeLayerReady) {
+        if (mMazeLayerDirty || mMazeLayerRevision != map.layoutRevision() || mMazeLayerTileSize != tileSize) {
+            rebuildMazeLayer(map, tileSize);
         }
+        submit(mMazeLayerSprite);
+    } else {
+        drawMazeStatic(mNative, map, tileSize, off, static_cast<float>(mHudHeight));
     }
 
-    sf::RectangleShape wall({tileSize, tileSize});
-    wall.setFillColor(sf::Color(20, 20, 200));
+    if (mPelletLayerDirty || mPelletLayoutRevision != map.layoutRevision() || mPelletTileSize != tileSize
+        || mPelletMapWidth != map.width() || mPelletMapHeight != map.height() || mPelletOffset != off) {
+        rebuildPelletLayer(map, tileSize);
+    } else if (mPelletCellRevision != map.cellRevision()) {
+        syncPelletLayer(map);
+    }
+
+    // Same texture as the entity batch; fallback quads sample its white texel.
+    const bool hasSheet = mAtlas.texture().getSize().x > 0;
+    submit(mPellets, sf::RenderStates(hasSheet ? &mAtlas.texture() : nullptr));
+}
 
-    // Pixel-ish dots
-    sf::RectangleShape dot({2.f, 2.f});
-    dot.setOrigin(1.f, 1.f);
-    dot.setFillColor(sf::Color(255, 220, 50));
+void Renderer::rebuildPelletLayer(const Map& map, float tileSize) {
+    mPelletLayerDirty = false;
+    mPelletLayoutRevision = map.layoutRevision();
+    mPelletCellRevision = map.cellRevision();
+    mPelletTileSize = tileSize;
+    mPelletMapWidth = map.width();
+    mPelletMapHeight = map.height();
+    mPelletOffset = playfieldOffset(map, tileSize);
 
-    sf::RectangleShape pellet({4.f, 4.f});
-    pellet.setOrigin(2.f, 2.f);
-    pellet.setFillColor(sf::Color(255, 220, 50));
+    const std::size_t cellCount = static_cast<std::size_t>(map.width()) * static_cast<std::size_t>(map.height());
+    mPelletQuadOfCell.assign(cellCount, -1);
+    mPelletCells.assign(cellCount, ' ');
 
+    std::size_t quads = 0;
     for (int y = 0; y < map.height(); ++y) {
         for (int x = 0; x < map.width(); ++x) {
             const char c = map.cell(x, y);
-            const float px = off.x + static_cast<float>(x) * tileSize;
-            const float py = off.y + static_cast<float>(y) * tileSize;
+            if (c == '.' || c == 'o') {
+                mPelletQuadOfCell[static_cast<std::size_t>(y * map.width() + x)] = static_cast<std::int32_t>(quads++);
+            }
+        }
+    }
 
-            if (c == '#') {
-                if (mHasTileTexture) {
-                    wallSprite.setPosition(px, py);
-                    mNative.draw(wallSprite);
-                } else {
-                    wall.setPosition(px, py);
-                    mNative.draw(wall);
-                }
-            } else if (c == '.') {
-                if (mHasMiniCoinTexture) {
-                    dotSprite.setPosition(px + tileSize * 0.5f, py + tileSize * 0.5f);
-                    mNative.draw(dotSprite);
-                } else {
-                    dot.setPosition(px + tileSize * 0.5f, py + tileSize * 0.5f);
-                    mNative.draw(dot);
-                }
-            } else if (c == 'o') {
-                if (mHasBigCoinTexture) {
-                    pelletSprite.setPosition(px + tileSize * 0.5f, py + tileSize * 0.5f);
-                    mNative.draw(pelletSprite);
-                } else {
-                    pellet.setPosition(px + tileSize * 0.5f, py + tileSize * 0.5f);
-                    mNative.draw(pellet);
-                }
+    mPellets.resize(quads * 4);
+    for (int y = 0; y < map.height(); ++y) {
+        for (int x = 0; x < map.width(); ++x) {
+            const std::size_t cellIndex = static_cast<std::size_t>(y * map.width() + x);
+            const std::int32_t quad = mPelletQuadOfCell[cellIndex];
+            if (quad >= 0) {
+                mPelletCells[cellIndex] = map.cell(x, y);
+                writePelletQuad(static_cast<std::size_t>(quad), x, y, mPelletCells[cellIndex]);
             }
         }
     }
 }
 
-void Renderer::drawPlayer(const Player& player, float tileSize) {
-    const sf::Vector2f off = mCachedPlayfieldOffset;
-    const sf::Vector2f p{player.position().x + off.x, player.position().y + off.y};
+void Renderer::syncPelletLayer(const Map& map) {
+    mPelletCellRevision = map.cellRevision();
+
+    for (int y = 0; y < map.height(); ++y) {
+        for (int x = 0; x < map.width(); ++x) {
+            const std::size_t cellIndex = static_cast<std::size_t>(y * map.width() + x);
+            const char c = map.cell(x, y);
+            const char shown = (c == '.' || c == 'o') ? c : ' ';
+            if (shown == mPelletCells[cellIndex]) {
+                continue;
+            }
 
-    float rotation = 0.f;
+            const std::int32_t quad = mPelletQuadOfCell[cellIndex];
+            if (quad < 0) {
+                // A pellet appeared where the level started without one; lay the array out again.
+                rebuildPelletLayer(map, mPelletTileSize);
+                return;
+            }
+            mPelletCells[cellIndex] = shown;
+            writePelletQuad(static_cast<std::size_t>(quad), x, y, shown);
+        }
+    }
+}
+
+void Renderer::writePelletQuad(std::size_t quad, int x, int y, char c) {
+    sf::Vertex* v = &mPellets[quad * 4];
+
+    if (c != '.' && c != 'o') {
+        // Eaten: collapse the quad so it rasterizes nothing.
+        for (int i = 0; i < 4; ++i) {
+            v[i].position = v[0].position;
+            v[i].color = sf::Color::Transparent;
+        }
+        return;
+    }
+
+    const bool power = (c == 'o');
+    const bool textured = (power ? mPowerFrame : mDotFrame) != InvalidSprite;
+    const sf::IntRect& rect = mAtlas.frameRect(textured ? (power ? mPowerFrame : mDotFrame) : mWhiteFrame);
+
+    // Sprites scale to a fraction of the tile width; fallback squares are 2px / 4px.
+    sf::Vector2f size;
+    if (textured && rect.width > 0) {
+        const float scale = (mPelletTileSize * (power ? 0.7f : 0.5f)) / static_cast<float>(rect.width);
+        size = {static_cast<float>(rect.width) * scale, static_cast<float>(rect.height) * scale};
+    } else {
+        size = power ? sf::Vector2f(4.f, 4.f) : sf::Vector2f(2.f, 2.f);
+    }
+
+    const float cx = mPelletOffset.x + (static_cast<float>(x) + 0.5f) * mPelletTileSize;
+    const float cy = mPelletOffset.y + (static_cast<float>(y) + 0.5f) * mPelletTileSize;
+    const float left = cx - size.x * 0.5f;
+    const float top = cy - size.y * 0.5f;
+
+    v[0].position = {left, top};
+    v[1].position = {left + size.x, top};
+    v[2].position = {left + size.x, top + size.y};
+    v[3].position = {left, top + size.y};
+
+    if (textured) {
+        const float u0 = static_cast<float>(rect.left);
+        const float v0 = static_cast<float>(rect.top);
+        const float u1 = u0 + static_cast<float>(rect.width);
+        const float v1 = v0 + static_cast<float>(rect.height);
+        v[0].texCoords = {u0, v0};
+        v[1].texCoords = {u1, v0};
+        v[2].texCoords = {u1, v1};
+        v[3].texCoords = {u0, v1};
+        for (int i = 0; i < 4; ++i) {
+            v[i].color = sf::Color::White;
+        }
+    } else {
+        const sf::Vector2f texel(static_cast<float>(rect.left) + 0.5f, static_cast<float>(rect.top) + 0.5f);
+        for (int i = 0; i < 4; ++i) {
+            v[i].texCoords = texel;
+            v[i].color = sf::Color(255, 220, 50);
+        }
+    }
+}
+
+void Renderer::drawPlayer(const Player& player, sf::Vector2f previousPosition, float tileSize) {
+    const sf::Vector2f p = interpolate(previousPosition, player.position(), tileSize) + mCachedPlayfieldOffset;
+
+    // Clockwise quarter turns from the right-facing frame.
+    int quarterTurns = 0;
     switch (player.direction()) {
-    case Direction::Right: rotation = 0.f; break;
-    case Direction::Left: rotation = 180.f; break;
-    case Direction::Up: rotation = 270.f; break;
-    case Direction::Down: rotation = 90.f; break;
-    default: rotation = 0.f; break;
-    }
-
-    if (mHasAtlas) {
-        const char* frame = (player.mouthOpen01() > 0.5f) ? "pacman_open" : "pacman_closed";
-        sf::Sprite s = mAtlas.makeSprite(frame);
-        const float scale = tileSize / 8.f;
-        s.setScale(scale, scale);
-        s.setRotation(rotation);
-        s.setPosition(p);
-        mNative.draw(s);
+    case Direction::Right: quarterTurns = 0; break;
+    case Direction::Left: quarterTurns = 2; break;
+    case Direction::Up: quarterTurns = 3; break;
+    case Direction::Down: quarterTurns = 1; break;
+    default: quarterTurns = 0; break;
+    }
+
+    const SpriteHandle frame = (player.mouthOpen01() > 0.5f) ? mPacmanOpenFrame : mPacmanClosedFrame;
+    if (mHasAtlas && frame != InvalidSprite) {
+        mAtlas.appendQuad(mSpriteBatch, frame, p, tileSize / 8.f, quarterTurns);
         return;
     }
 
+    flushSprites();
+    const float rotation = 90.f * static_cast<float>(quarterTurns);
+
     const float r = player.radius(tileSize);
 
-    sf::CircleShape body(r, 32);
-    body.setOrigin(r, r);
-    body.setPosition(p);
-    body.setFillColor(sf::Color(255, 230, 40));
-    mNative.draw(body);
+    mPlayerBody.setRadius(r);
+    mPlayerBody.setOrigin(r, r);
+    mPlayerBody.setPosition(p);
+    submit(mPlayerBody);
 
     // Mouth: a black triangle over the circle.
     const float open01 = player.mouthOpen01();
     const float mouthAngle = (18.f + 55.f * open01) * 3.1415926f / 180.f;
 
-    sf::ConvexShape mouth;
-    mouth.setPointCount(3);
-    mouth.setPoint(0, {0.f, 0.f});
-    mouth.setPoint(1, {r * 1.25f, -std::tan(mouthAngle) * (r * 0.9f)});
-    mouth.setPoint(2, {r * 1.25f, std::tan(mouthAngle) * (r * 0.9f)});
-    mouth.setFillColor(sf::Color::Black);
-    mouth.setPosition(p);
-    mouth.setRotation(rotation);
-    mNative.draw(mouth);
+    mPlayerMouth.setPoint(0, {0.f, 0.f});
+    mPlayerMouth.setPoint(1, {r * 1.25f, -std::tan(mouthAngle) * (r * 0.9f)});
+    mPlayerMouth.setPoint(2, {r * 1.25f, std::tan(mouthAngle) * (r * 0.9f)});
+    mPlayerMouth.setPosition(p);
+    mPlayerMouth.setRotation(rotation);
+    submit(mPlayerMouth);
 }
 
-void Renderer::drawGhost(const Ghost& ghost, float tileSize) {
-    const sf::Vector2f off = mCachedPlayfieldOffset;
-    const sf::Vector2f p{ghost.position().x + off.x, ghost.position().y + off.y};
-
-    if (mHasAtlas) {
-        const char* frame = "ghost_red";
-        if (ghost.mode() == GhostMode::Frightened) {
-            frame = "ghost_fright";
-        } else if (ghost.mode() == GhostMode::Eaten) {
-            frame = "ghost_eaten";
-        } else {
-            switch (ghost.id()) {
-            case GhostId::Blinky: frame = "ghost_red"; break;
-            case GhostId::Pinky: frame = "ghost_pink"; break;
-            case GhostId::Inky: frame = "ghost_cyan"; break;
-            case GhostId::Clyde: frame = "ghost_orange"; break;
-            }
-        }
+void Renderer::drawGhost(const Ghost& ghost, sf::Vector2f previousPosition, float tileSize) {
+    const sf::Vector2f p = interpolate(previousPosition, ghost.position(), tileSize) + mCachedPlayfieldOffset;
+
+    SpriteHandle frame = mGhostFrames[static_cast<std::size_t>(ghost.id())];
+    if (ghost.mode() == GhostMode::Frightened) {
+        frame = mGhostFrightFrame;
+    } else if (ghost.mode() == GhostMode::Eaten) {
+        frame = mGhostEatenFrame;
+    }
 
-        sf::Sprite s = mAtlas.makeSprite(frame);
-        const float scale = tileSize / 8.f;
-        s.setScale(scale, scale);
-        s.setPosition(p);
-        mNative.draw(s);
+    if (mHasAtlas && frame != InvalidSprite) {
+        mAtlas.appendQuad(mSpriteBatch, frame, p, tileSize / 8.f);
         return;
     }
 
+    flushSprites();
+
     const float r = tileSize * 0.42f;
 
-    sf::CircleShape head(r, 18);
-    head.setOrigin(r, r);
-    head.setPosition(p);
-    head.setFillColor(ghost.color());
+    mGhostHead.setRadius(r);
+    mGhostHead.setOrigin(r, r);
+    mGhostHead.setPosition(p);
+    mGhostHead.setFillColor(ghostColor(ghost));
 
-    sf::RectangleShape body({r * 2.f, r});
-    body.setOrigin(r, 0.f);
-    body.setPosition(p.x, p.y);
-    body.setFillColor(ghost.color());
+    mGhostBody.setSize({r * 2.f, r});
+    mGhostBody.setOrigin(r, 0.f);
+    mGhostBody.setPosition(p.x, p.y);
+    mGhostBody.setFillColor(ghostColor(ghost));
 
-    mNative.draw(body);
-    mNative.draw(head);
+    submit(mGhostBody);
+    submit(mGhostHead);
 
     // Eyes (simple placeholder)
-    sf::CircleShape eyeWhite(r * 0.22f, 12);
-    eyeWhite.setFillColor(sf::Color::White);
-    eyeWhite.setOrigin(eyeWhite.getRadius(), eyeWhite.getRadius());
+    mGhostEyeWhite.setRadius(r * 0.22f);
+    mGhostEyeWhite.setOrigin(mGhostEyeWhite.getRadius(), mGhostEyeWhite.getRadius());
 
-    sf::CircleShape pupil(r * 0.10f, 10);
-    pupil.setFillColor(sf::Color::Blue);
-    pupil.setOrigin(pupil.getRadius(), pupil.getRadius());
+    mGhostPupil.setRadius(r * 0.10f);
+    mGhostPupil.setOrigin(mGhostPupil.getRadius(), mGhostPupil.getRadius());
 
-    eyeWhite.setPosition(p.x - r * 0.25f, p.y - r * 0.12f);
-    mNative.draw(eyeWhite);
-    eyeWhite.setPosition(p.x + r * 0.25f, p.y - r * 0.12f);
-    mNative.draw(eyeWhite);
+    mGhostEyeWhite.setPosition(p.x - r * 0.25f, p.y - r * 0.12f);
+    submit(mGhostEyeWhite);
+    mGhostEyeWhite.setPosition(p.x + r * 0.25f, p.y - r * 0.12f);
+    submit(mGhostEyeWhite);
 
-    pupil.setPosition(p.x - r * 0.25f, p.y - r * 0.12f);
-    mNative.draw(pupil);
-    pupil.setPosition(p.x + r * 0.25f, p.y - r * 0.12f);
-    mNative.draw(pupil);
+    mGhostPupil.setPosition(p.x - r * 0.25f, p.y - r * 0.12f);
+    submit(mGhostPupil);
+    mGhostPupil.setPosition(p.x + r * 0.25f, p.y - r * 0.12f);
+    submit(mGhostPupil);
 }
 
 void Renderer::drawFruit(TileCoord tile, float tileSize) {
+    flushSprites();
     const sf::Vector2f off = mCachedPlayfieldOffset;
 
-    sf::RectangleShape fruit({tileSize * 0.75f, tileSize * 0.75f});
-    fruit.setOrigin(fruit.getSize().x * 0.5f, fruit.getSize().y * 0.5f);
-    fruit.setFillColor(sf::Color(255, 60, 200));
+    mFruitShape.setSize({tileSize * 0.75f, tileSize * 0.75f});
+    mFruitShape.setOrigin(mFruitShape.getSize().x * 0.5f, mFruitShape.getSize().y * 0.5f);
 
     const float x = off.x + (static_cast<float>(tile.x) + 0.5f) * tileSize;
     const float y = off.y + (static_cast<float>(tile.y) + 0.5f) * tileSize;
-    fruit.setPosition(x, y);
-    mNative.draw(fruit);
+    mFruitShape.setPosition(x, y);
+    submit(mFruitShape);
 }
 
 void Renderer::drawHUD(int score, int lives, int level) {
-    const std::string sScore = "SCORE " + std::to_string(score);
-    const std::string sLives = "LIVES " + std::to_string(lives);
-    const std::string sLevel = "LVL " + std::to_string(level);
+    PACMAN_ZONE("Renderer::drawHUD");
+    if (mHudDirty || score != mHudScore || lives != mHudLives || level != mHudLevel) {
+        rebuildHud(score, lives, level);
+    }
 
     if (mHasFont) {
-        sf::Text t;
-        t.setFont(mFont);
-        t.setCharacterSize(10);
-        t.setLetterSpacing(1.2f);
-        t.setFillColor(sf::Color(240, 240, 240));
-
-        t.setString(sScore);
-        t.setPosition(4.f, 6.f);
-        mNative.draw(t);
-
-        // Draw hearts for lives
-        if (mHasHeartTexture) {
-            sf::Sprite heart;
-            heart.setTexture(mHeartTexture);
-            const auto sz = mHeartTexture.getSize();
-            if (sz.x > 0) {
+        submit(mHudScoreText.text);
+        if (mHeartFrame != InvalidSprite) {
+            // No flush: the hearts join the entity batch, and nothing queued there overlaps the HUD text.
+            for (std::size_t i = 0; i < mHudHearts.getVertexCount(); ++i) {
+                mSpriteBatch.append(mHudHearts[i]);
+            }
+        } else {
+            submit(mHudLivesText.text);
+        }
+        submit(mHudLevelText.text);
+        return;
+    }
+
+    submit(mHudBitmapText, sf::RenderStates(&mBitmapFont.texture()));
+}
+
+void Renderer::rebuildHud(int score, int lives, int level) {
+    mHudDirty = false;
+    mHudScore = score;
+    mHudLives = lives;
+    mHudLevel = level;
+
+    char sScore[24];
+    char sLives[24];
+    char sLevel[24];
+    std::snprintf(sScore, sizeof(sScore), "SCORE %d", score);
+    std::snprintf(sLives, sizeof(sLives), "LIVES %d", lives);
+    std::snprintf(sLevel, sizeof(sLevel), "LVL %d", level);
+
+    mHudHearts.clear();
+    mHudBitmapText.clear();
+
+    if (mHasFont) {
+        for (sf::Text* t : {&mHudScoreText.text, &mHudLivesText.text, &mHudLevelText.text}) {
+            t->setFont(mFont);
+            t->setCharacterSize(10);
+            t->setLetterSpacing(1.2f);
+            t->setFillColor(sf::Color(240, 240, 240));
+        }
+
+        setRetainedText(mHudScoreText, sScore);
+        mHudScoreText.text.setPosition(4.f, 6.f);
+
+        setRetainedText(mHudLivesText, sLives);
+        const auto mid = mHudLivesText.text.getLocalBounds();
+        mHudLivesText.text.setPosition(std::floor((static_cast<float>(mNativeWidth) - mid.width) * 0.5f), 6.f);
+
+        setRetainedText(mHudLevelText, sLevel);
+        const auto rb = mHudLevelText.text.getLocalBounds();
+        mHudLevelText.text.setPosition(static_cast<float>(mNativeWidth) - rb.width - 4.f, 6.f);
+
+        // Hearts for lives, laid out centred in the strip.
+        if (mHeartFrame != InvalidSprite) {
+            const sf::IntRect& rect = mAtlas.frameRect(mHeartFrame);
+            if (rect.width > 0) {
                 const float target = 12.f;
-                const float scale = target / static_cast<float>(sz.x);
-                heart.setScale(scale, scale);
+                const float scale = target / static_cast<float>(rect.width);
+                const float halfH = static_cast<float>(rect.height) * scale * 0.5f;
                 const float spacing = 4.f;
                 const float totalW = (static_cast<float>(lives) * target) + (static_cast<float>(lives - 1) * spacing);
                 float startX = std::floor((static_cast<float>(mNativeWidth) - totalW) * 0.5f);
                 const float y = 4.f;
                 for (int i = 0; i < lives; ++i) {
-                    heart.setPosition(startX + static_cast<float>(i) * (target + spacing), y);
-                    mNative.draw(heart);
+                    const float left = startX + static_cast<float>(i) * (target + spacing);
+                    mAtlas.appendQuad(mHudHearts, mHeartFrame, {left + target * 0.5f, y + halfH}, scale);
                 }
             }
-        } else {
-            t.setString(sLives);
-            const auto mid = t.getLocalBounds();
-            t.setPosition(std::floor((static_cast<float>(mNativeWidth) - mid.width) * 0.5f), 6.f);
-            mNative.draw(t);
         }
-
-        t.setString(sLevel);
-        const auto rb = t.getLocalBounds();
-        t.setPosition(static_cast<float>(mNativeWidth) - rb.width - 4.f, 6.f);
-        mNative.draw(t);
         return;
     }
 
     // BitmapFont fallback - use scale 1 to fit in 256px width
     const int scale = 1;
     const sf::Color hudColor(240, 240, 240);
-    
-    // Draw SCORE on left
-    mBitmapFont.draw(mNative, sScore, {4.f, 8.f}, scale, hudColor);
 
-    // Draw LIVES in center
+    // SCORE on left
+    mBitmapFont.append(mHudBitmapText, sScore, {4.f, 8.f}, scale, hudColor);
+
+    // LIVES in center
     const sf::Vector2f m = mBitmapFont.measure(sLives, scale);
-    mBitmapFont.draw(mNative, sLives, {std::floor((static_cast<float>(mNativeWidth) - m.x) * 0.5f), 8.f}, scale, hudColor);
+    mBitmapFont.append(mHudBitmapText, sLives, {std::floor((static_cast<float>(mNativeWidth) - m.x) * 0.5f), 8.f}, scale, hudColor);
 
-    // Draw LVL on right
+    // LVL on right
     const sf::Vector2f r = mBitmapFont.measure(sLevel, scale);
-    mBitmapFont.draw(mNative, sLevel, {static_cast<float>(mNativeWidth) - r.x - 4.f, 8.f}, scale, hudColor);
+    mBitmapFont.append(mHudBitmapText, sLevel, {static_cast<float>(mNativeWidth) - r.x - 4.f, 8.f}, scale, hudColor);
 }
 
-void Renderer::drawOverlayText(const std::string& title, const std::string& subtitle) {
-    sf::RectangleShape dim({static_cast<float>(mNativeWidth), static_cast<float>(mNativeHeight)});
-    dim.setFillColor(sf::Color(0, 0, 0, 210));
-    dim.setPosition(0.f, 0.f);
-    mNative.draw(dim);
+void Renderer::drawOverlayText(std::string_view title, std::string_view subtitle) {
+    flushSprites();
+
+    mDimShape.setFillColor(sf::Color(0, 0, 0, 210));
+    submit(mDimShape);
 
     if (mHasFont) {
-        sf::Text t;
-        t.setFont(mFont);
-        t.setFillColor(sf::Color::White);
-        t.setLetterSpacing(1.0f);
+        for (RetainedText* r : {&mOverlayTitleText, &mOverlaySubtitleText}) {
+            r->text.setFont(mFont);
+            r->text.setFillColor(sf::Color::White);
+            r->text.setLetterSpacing(1.0f);
+        }
 
+        sf::Text& t = mOverlayTitleText.text;
         t.setCharacterSize(18);
-        t.setString(title);
+        setRetainedText(mOverlayTitleText, title);
         auto tb = t.getLocalBounds();
         t.setOrigin(tb.left + tb.width * 0.5f, tb.top + tb.height * 0.5f);
         t.setPosition(static_cast<float>(mNativeWidth) * 0.5f, static_cast<float>(mNativeHeight) * 0.40f);
-        mNative.draw(t);
-
-        t.setCharacterSize(8);
-        t.setString(subtitle);
-        auto sb = t.getLocalBounds();
-        t.setOrigin(sb.left + sb.width * 0.5f, sb.top + sb.height * 0.5f);
-        t.setPosition(static_cast<float>(mNativeWidth) * 0.5f, static_cast<float>(mNativeHeight) * 0.53f);
-        mNative.draw(t);
+        submit(t);
+
+        sf::Text& s = mOverlaySubtitleText.text;
+        s.setCharacterSize(8);
+        setRetainedText(mOverlaySubtitleText, subtitle);
+        auto sb = s.getLocalBounds();
+        s.setOrigin(sb.left + sb.width * 0.5f, sb.top + sb.height * 0.5f);
+        s.setPosition(static_cast<float>(mNativeWidth) * 0.5f, static_cast<float>(mNativeHeight) * 0.53f);
+        submit(s);
         return;
     }
 
     const int titleScale = 3;
     const sf::Vector2f tsize = mBitmapFont.measure(title, titleScale);
-    mBitmapFont.draw(mNative, title, {std::floor((static_cast<float>(mNativeWidth) - tsize.x) * 0.5f), 110.f}, titleScale, sf::Color::White);
+    mOverlayTitleMesh.set(mBitmapFont, title, {std::floor((static_cast<float>(mNativeWidth) - tsize.x) * 0.5f), 110.f}, titleScale, sf::Color::White);
+    submit(mOverlayTitleMesh);
 
     const int subScale = 2;
     const sf::Vector2f ssize = mBitmapFont.measure(subtitle, subScale);
-    mBitmapFont.draw(mNative, subtitle, {std::floor((static_cast<float>(mNativeWidth) - ssize.x) * 0.5f), 150.f}, subScale, sf::Color(220, 220, 220));
+    mOverlaySubtitleMesh.set(mBitmapFont, subtitle, {std::floor((static_cast<float>(mNativeWidth) - ssize.x) * 0.5f), 150.f}, subScale, sf::Color(220, 220, 220));
+    submit(mOverlaySubtitleMesh);
+}
+
+void Renderer::drawLoadingBar(float progress) {
+    flushSprites();
+
+    const float barHeight = 2.f;
+    mLoadingBar.setSize({static_cast<float>(mNativeWidth) * std::clamp(progress, 0.f, 1.f), barHeight});
+    mLoadingBar.setPosition(0.f, static_cast<float>(mNativeHeight) - barHeight);
+    submit(mLoadingBar);
 }
 
 void Renderer::drawMenu(const Menu& menu) {
+    flushSprites();
+
     // Inspired by provided menu mockup: tinted panel with neon accent and centered items
-    sf::RectangleShape dim({static_cast<float>(mNativeWidth), static_cast<float>(mNativeHeight)});
-    dim.setFillColor(sf::Color(12, 30, 55, 235));
-    dim.setPosition(0.f, 0.f);
-    mNative.draw(dim);
-
-    sf::RectangleShape frame({static_cast<float>(mNativeWidth) - 14.f, static_cast<float>(mNativeHeight) - 14.f});
-    frame.setPosition(7.f, 7.f);
-    frame.setFillColor(sf::Color(0, 0, 0, 0));
-    frame.setOutlineColor(sf::Color(50, 184, 198));
-    frame.setOutlineThickness(2.f);
-    mNative.draw(frame);
+    mDimShape.setFillColor(sf::Color(12, 30, 55, 235));
+    submit(mDimShape);
+    submit(mMenuFrame);
 
     const sf::Color normal(160, 200, 220);
     const sf::Color selected(255, 196, 80);
 
     if (mHasFont) {
-        sf::Text t;
+        if (mMenuItemTexts.size() < menu.items().size()) {
+            mMenuItemTexts.resize(menu.items().size());
+        }
+
+        sf::Text& t = mMenuTitleText.text;
         t.setFont(mFont);
         t.setLetterSpacing(1.05f);
-
         t.setCharacterSize(24);
         t.setFillColor(sf::Color::White);
-        t.setString(menu.title());
+        setRetainedText(mMenuTitleText, menu.title());
         auto b = t.getLocalBounds();
         t.setOrigin(b.left + b.width * 0.5f, b.top + b.height * 0.5f);
         t.setPosition(static_cast<float>(mNativeWidth) * 0.5f, 60.f);
-        mNative.draw(t);
+        submit(t);
 
         float y = 120.f;
         for (std::size_t i = 0; i < menu.items().size(); ++i) {
-            t.setCharacterSize(16);
+            sf::Text& item = mMenuItemTexts[i].text;
+            item.setFont(mFont);
+            item.setLetterSpacing(1.05f);
+            item.setCharacterSize(16);
             const bool isSel = (i == menu.selectedIndex());
-            t.setFillColor(isSel ? selected : normal);
-            t.setString(menu.items()[i]);
-            auto ib = t.getLocalBounds();
-            t.setOrigin(ib.left + ib.width * 0.5f, ib.top + ib.height * 0.5f);
-            t.setPosition(static_cast<float>(mNativeWidth) * 0.5f, y);
-            mNative.draw(t);
+            item.setFillColor(isSel ? selected : normal);
+            setRetainedText(mMenuItemTexts[i], menu.items()[i]);
+            auto ib = item.getLocalBounds();
+            item.setOrigin(ib.left + ib.width * 0.5f, ib.top + ib.height * 0.5f);
+            item.setPosition(static_cast<float>(mNativeWidth) * 0.5f, y);
+            submit(item);
 
             // no selection braces or arrows for a cleaner look
 
@@ -515,15 +870,22 @@ void Renderer::drawMenu(const Menu& menu) {
 
     const int titleScale = 3;
     const sf::Vector2f titleSize = mBitmapFont.measure(menu.title(), titleScale);
-    mBitmapFont.draw(mNative, menu.title(), {std::floor((static_cast<float>(mNativeWidth) - titleSize.x) * 0.5f), 60.f}, titleScale, sf::Color::White);
+    mMenuTitleMesh.set(mBitmapFont, menu.title(), {std::floor((static_cast<float>(mNativeWidth) - titleSize.x) * 0.5f), 60.f}, titleScale, sf::Color::White);
+    submit(mMenuTitleMesh);
+
+    if (mMenuItemMeshes.size() < menu.items().size()) {
+        mMenuItemMeshes.resize(menu.items().size());
+    }
 
     const int itemScale = 2;
     float y = 120.f;
     for (std::size_t i = 0; i < menu.items().size(); ++i) {
         const bool isSel = (i == menu.selectedIndex());
-        const std::string label = isSel ? "> " + menu.items()[i] : "  " + menu.items()[i];
-        const sf::Vector2f itemSize = mBitmapFont.measure(label, itemScale);
-        mBitmapFont.draw(mNative, label, {std::floor((static_cast<float>(mNativeWidth) - itemSize.x) * 0.5f), y}, itemScale, isSel ? selected : normal);
+        mMenuLabel.assign(isSel ? "> " : "  ");
+        mMenuLabel += menu.items()[i];
+        const sf::Vector2f itemSize = mBitmapFont.measure(mMenuLabel, itemScale);
+        mMenuItemMeshes[i].set(mBitmapFont, mMenuLabel, {std::floor((static_cast<float>(mNativeWidth) - itemSize.x) * 0.5f), y}, itemScale, isSel ? selected : normal);
+        submit(mMenuItemMeshes[i]);
         y += 28.f;
     }
 }
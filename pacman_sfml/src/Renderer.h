@@ -4,14 +4,26 @@
 #include "SpriteAtlas.h"
 #include "Types.h"
 
+#include <SFML/Graphics/CircleShape.hpp>
+#include <SFML/Graphics/ConvexShape.hpp>
 #include <SFML/Graphics/Font.hpp>
+#include <SFML/Graphics/RectangleShape.hpp>
 #include <SFML/Graphics/RenderTexture.hpp>
 #include <SFML/Graphics/RenderWindow.hpp>
+#include <SFML/Graphics/Shape.hpp>
 #include <SFML/Graphics/Sprite.hpp>
+#include <SFML/Graphics/Text.hpp>
 #include <SFML/Graphics/Texture.hpp>
 #include <SFML/Graphics/Image.hpp>
+#include <SFML/Graphics/VertexArray.hpp>
 
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <string>
+#include <string_view>
+#include <vector>
 
 class Map;
 class Player;
@@ -22,11 +34,22 @@ class Renderer {
 public:
     explicit Renderer(sf::RenderWindow& window);
 
+    // Standalone images packed into the atlas next to the sprite sheet frames.
+    enum class AtlasImage {
+        Tile,
+        Dot,
+        PowerPellet,
+        Heart,
+    };
+
     bool loadFont(const std::string& path);
-    bool loadAtlas(const std::string& imagePath, const std::string& jsonPath);
-    bool loadBackground(const std::string& path);
-    bool loadMapSprites(const std::string& tilePath, const std::string& smallDotPath, const std::string& bigDotPath);
-    bool loadHeartTexture(const std::string& path);
+    // The bytes (an AssetPack entry) must stay valid while the font is in use.
+    bool loadFontFromMemory(const void* data, std::size_t size);
+    // Assets arrive already decoded (see AssetLoader), in any order; each one is uploaded when it
+    // is set and the scene falls back to shapes until then.
+    bool setAtlasFrames(const std::vector<SpriteAtlas::Frame>& frames);
+    bool setBackground(const sf::Image& image);
+    bool addAtlasImage(AtlasImage which, const sf::Image& image);
 
     // Native pixel-art frame (rendered to a RenderTexture, then integer-scaled).
     int nativeWidth() const { return mNativeWidth; }
@@ -37,14 +60,31 @@ public:
     void beginFrame();
     void endFrame();
 
+    // Fraction of a simulation tick elapsed since the newest state, in [0, 1]. Entities are
+    // drawn between their previous-tick and current positions so motion stays smooth on
+    // displays faster than the 60 Hz simulation. 1 draws the current state as-is.
+    void setInterpolationAlpha(float alpha);
+
     void drawMap(const Map& map, float tileSize);
-    void drawPlayer(const Player& player, float tileSize);
-    void drawGhost(const Ghost& ghost, float tileSize);
+    void drawPlayer(const Player& player, sf::Vector2f previousPosition, float tileSize);
+    void drawGhost(const Ghost& ghost, sf::Vector2f previousPosition, float tileSize);
     void drawFruit(TileCoord tile, float tileSize);
 
     void drawHUD(int score, int lives, int level);
-    void drawOverlayText(const std::string& title, const std::string& subtitle);
+    void drawOverlayText(std::string_view title, std::string_view subtitle);
     void drawMenu(const Menu& menu);
+    // Thin bar along the bottom edge while assets are still loading; `progress` in [0, 1].
+    void drawLoadingBar(float progress);
+
+    // Operator performance overlay, drawn over the finished frame by endFrame(): frame time,
+    // CPU time split into simulation and rendering, ticks per frame, draw calls and vertices
+    // submitted to the native target, and a graph of recent frame times.
+    void setPerfOverlayVisible(bool visible) { mPerfOverlayVisible = visible; }
+    bool perfOverlayVisible() const { return mPerfOverlayVisible; }
+    // Simulation work since the previous frame, shown by the overlay.
+    void setSimFrameStats(int ticks, float simMs);
+    // Heap allocations during the previous frame on the simulation and main threads.
+    void setAllocationStats(std::uint32_t simAllocations, std::uint32_t frameAllocations);
 
     // Coordinate transformation from window to native resolution
     sf::Vector2f windowToNative(sf::Vector2i windowPos, sf::Vector2u windowSize) const;
@@ -62,25 +102,155 @@ private:
     sf::Font mFont;
     BitmapFont mBitmapFont;
 
+    // Every frame drawn in the playfield and the HUD hearts live in this one texture: the
+    // sprite sheet, wall tile, both coins, the heart and a white texel for untextured quads.
+    // The background stays separate: it is filtered smoothly and only drawn into the maze layer.
     bool mHasAtlas = false;
     SpriteAtlas mAtlas;
+    bool repackAtlas();
+
+    // Frames resolved once at load time; InvalidSprite falls back to the shape renderer.
+    SpriteHandle mPacmanOpenFrame = InvalidSprite;
+    SpriteHandle mPacmanClosedFrame = InvalidSprite;
+    std::array<SpriteHandle, 4> mGhostFrames{InvalidSprite, InvalidSprite, InvalidSprite, InvalidSprite};
+    SpriteHandle mGhostFrightFrame = InvalidSprite;
+    SpriteHandle mGhostEatenFrame = InvalidSprite;
+    SpriteHandle mTileFrame = InvalidSprite;
+    SpriteHandle mDotFrame = InvalidSprite;
+    SpriteHandle mPowerFrame = InvalidSprite;
+    SpriteHandle mHeartFrame = InvalidSprite;
+    SpriteHandle mWhiteFrame = InvalidSprite;
+
+    // Atlas quads queued by drawPlayer()/drawGhost()/drawHUD(); drawn in one call before anything
+    // else touches the frame. The array keeps its capacity, so steady-state frames do not allocate.
+    sf::VertexArray mSpriteBatch{sf::Quads};
+    void flushSprites();
 
     bool mHasBackground = false;
     sf::Texture mBackgroundTexture;
     sf::Sprite mBackgroundSprite;
 
-    bool mHasTileTexture = false;
-    bool mHasMiniCoinTexture = false;
-    bool mHasBigCoinTexture = false;
-    bool mHasHeartTexture = false;
-    sf::Texture mTileTexture;
-    sf::Texture mMiniCoinTexture;
-    sf::Texture mBigCoinTexture;
-    sf::Texture mHeartTexture;
-
     sf::Vector2f playfieldOffset(const Map& map, float tileSize) const;
+    sf::Vector2f interpolate(sf::Vector2f previous, sf::Vector2f current, float tileSize) const;
+
+    float mAlpha = 1.f;
+
     void presentToWindow();
 
+    // Background + walls, pre-rendered below the HUD strip. Rebuilt only when the maze layout,
+    // tile size or map textures change; drawMap() blits it and adds the dynamic cells on top.
+    void rebuildMazeLayer(const Map& map, float tileSize);
+    void drawMazeStatic(sf::RenderTarget& target, const Map& map, float tileSize, sf::Vector2f off, float top);
+
+    sf::RenderTexture mMazeLayer;
+    sf::Sprite mMazeLayerSprite;
+    bool mMazeLayerReady = false;
+    bool mMazeLayerDirty = true;
+    std::uint32_t mMazeLayerRevision = 0;
+    float mMazeLayerTileSize = 0.f;
+
+    // Every dot and power pellet as one quad in a single vertex array, built once per level.
+    // Cells that change afterwards (eaten, restored) rewrite only their own quad.
+    void rebuildPelletLayer(const Map& map, float tileSize);
+    void syncPelletLayer(const Map& map);
+    void writePelletQuad(std::size_t quad, int x, int y, char c);
+
+    sf::VertexArray mPellets{sf::Quads};
+    std::vector<std::int32_t> mPelletQuadOfCell; // -1: no quad for this cell
+    std::vector<char> mPelletCells;             // cell contents the quads currently show
+    sf::Vector2f mPelletOffset{0.f, 0.f};
+    float mPelletTileSize = 0.f;
+    int mPelletMapWidth = 0;
+    int mPelletMapHeight = 0;
+    std::uint32_t mPelletLayoutRevision = 0;
+    std::uint32_t mPelletCellRevision = 0;
+    bool mPelletLayerDirty = true;
+
+    // HUD laid out only when score, lives or level change (or fonts/atlas reload); other frames
+    // just draw the retained texts and copy the heart quads into the sprite batch.
+    void rebuildHud(int score, int lives, int level);
+
+    bool mHudDirty = true;
+    int mHudScore = 0;
+    int mHudLives = 0;
+    int mHudLevel = 0;
+    // sf::Text whose string is converted and laid out again only when its content changes;
+    // converting a std::string to sf::String allocates, so steady frames must skip it.
+    struct RetainedText {
+        sf::Text text;
+        std::string content;
+        sf::String glyphs;
+    };
+    static void setRetainedText(RetainedText& retained, std::string_view content);
+
+    RetainedText mHudScoreText;
+    RetainedText mHudLivesText;
+    RetainedText mHudLevelText;
+    sf::VertexArray mHudHearts{sf::Quads};
+    sf::VertexArray mHudBitmapText{sf::Quads};
+
+    RetainedText mOverlayTitleText;
+    RetainedText mOverlaySubtitleText;
+    RetainedText mMenuTitleText;
+    std::vector<RetainedText> mMenuItemTexts;
+
+    // Shapes reused every frame. An sf::Shape allocates its vertices when it is built, but
+    // resizing or recolouring one with the same point count does not touch the heap.
+    sf::RectangleShape mHudStrip;
+    sf::RectangleShape mDimShape;
+    sf::RectangleShape mMenuFrame;
+    sf::RectangleShape mLoadingBar;
+    sf::RectangleShape mFruitShape;
+    sf::CircleShape mPlayerBody{0.f, 32};
+    sf::ConvexShape mPlayerMouth{3};
+    sf::CircleShape mGhostHead{0.f, 18};
+    sf::RectangleShape mGhostBody;
+    sf::CircleShape mGhostEyeWhite{0.f, 12};
+    sf::CircleShape mGhostPupil{0.f, 10};
+
+    // BitmapFont fallback text for overlays and menus, re-laid out only when its content changes.
+    TextMesh mOverlayTitleMesh;
+    TextMesh mOverlaySubtitleMesh;
+    TextMesh mMenuTitleMesh;
+    std::vector<TextMesh> mMenuItemMeshes;
+    std::string mMenuLabel;
+
+    // Every draw into mNative goes through submit() so the overlay can count calls and
+    // vertices. Text and shape counts follow what SFML submits for them.
+    void submit(const sf::VertexArray& vertices, const sf::RenderStates& states = sf::RenderStates::Default);
+    void submit(const sf::Shape& shape);
+    void submit(const sf::Sprite& sprite);
+    void submit(const sf::Text& text);
+    void submit(const TextMesh& mesh);
+
+    struct FrameCounters {
+        std::uint32_t drawCalls = 0;
+        std::uint32_t vertices = 0;
+    };
+
+    static constexpr std::size_t PerfHistory = 128;
+
+    void drawPerfOverlay();
+
+    FrameCounters mFrameCounters;
+    bool mPerfOverlayVisible = false;
+
+    // Figures of the last completed frame; the overlay always shows the one before it.
+    FrameCounters mLastCounters;
+    float mLastFrameMs = 0.f;
+    float mLastRenderMs = 0.f;
+    int mSimTicks = 0;
+    float mSimMs = 0.f;
+    std::uint32_t mSimAllocations = 0;
+    std::uint32_t mFrameAllocations = 0;
+
+    std::chrono::steady_clock::time_point mFrameStart{};
+    std::array<float, PerfHistory> mFrameTimes{};
+    std::size_t mFrameTimeHead = 0;
+
+    sf::VertexArray mPerfPanel{sf::Quads};
+    sf::VertexArray mPerfText{sf::Quads};
+
     // Cached after drawMap() for entity rendering.
     sf::Vector2f mCachedPlayfieldOffset{0.f, 0.f};
     float mCachedTileSize = 8.f;
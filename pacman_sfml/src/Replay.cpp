@@ -0,0 +1,230 @@
+#include "Replay.h"
+
+#include "GridMover.h"
+#include "Log.h"
+
+#include <algorithm>
+#include <iterator>
+
+namespace {
+constexpr char Magic[4] = {'P', 'M', 'R', 'P'};
+constexpr std::uint8_t Version = 1;
+constexpr std::uint8_t FlagFixedPoint = 1u << 0;
+
+constexpr std::uint64_t CodeNewGame = 6;
+constexpr std::uint64_t CodeEnd = 7;
+constexpr unsigned CodeBits = 3;
+
+constexpr std::size_t BufferSize = 64 * 1024;
+// Largest varint (64-bit value) is 10 bytes.
+constexpr std::size_t MaxVarintBytes = 10;
+
+std::uint8_t buildFlags() {
+    return PACMAN_FIXED_POINT ? FlagFixedPoint : 0;
+}
+}
+
+ReplayWriter::~ReplayWriter() {
+    close();
+}
+
+bool ReplayWriter::open(const std::string& path, std::uint32_t seed, const std::string& mapPath) {
+    close();
+
+    mOut.open(path, std::ios::binary | std::ios::trunc);
+    if (!mOut) {
+        PACMAN_LOG_ERROR("Failed to open replay for writing: %s", path.c_str());
+        return false;
+    }
+
+    mBuffer.clear();
+    mBuffer.reserve(BufferSize);
+    mRunDirection = Direction::None;
+    mRunLength = 0;
+
+    mBuffer.insert(mBuffer.end(), std::begin(Magic), std::end(Magic));
+    mBuffer.push_back(Version);
+    mBuffer.push_back(buildFlags());
+    writeVarint(seed);
+    writeVarint(mapPath.size());
+    mBuffer.insert(mBuffer.end(), mapPath.begin(), mapPath.end());
+    return true;
+}
+
+void ReplayWriter::recordTick(Direction requested) {
+    if (!isOpen()) {
+        return;
+    }
+    if (requested != mRunDirection && mRunLength > 0) {
+        flushRun();
+    }
+    mRunDirection = requested;
+    ++mRunLength;
+}
+
+void ReplayWriter::recordNewGame() {
+    if (!isOpen()) {
+        return;
+    }
+    flushRun();
+    writeVarint(CodeNewGame);
+}
+
+bool ReplayWriter::close() {
+    if (!isOpen()) {
+        return true;
+    }
+
+    flushRun();
+    writeVarint(CodeEnd);
+    flushBuffer();
+
+    const bool ok = static_cast<bool>(mOut);
+    mOut.close();
+    if (!ok) {
+        PACMAN_LOG_ERROR("Failed to write replay");
+    }
+    return ok;
+}
+
+void ReplayWriter::flushRun() {
+    if (mRunLength == 0) {
+        return;
+    }
+    writeVarint((mRunLength << CodeBits) | static_cast<std::uint64_t>(mRunDirection));
+    mRunLength = 0;
+}
+
+void ReplayWriter::writeVarint(std::uint64_t value) {
+    if (mBuffer.size() + MaxVarintBytes > BufferSize) {
+        flushBuffer();
+    }
+    while (value >= 0x80) {
+        mBuffer.push_back(static_cast<std::uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    mBuffer.push_back(static_cast<std::uint8_t>(value));
+}
+
+void ReplayWriter::flushBuffer() {
+    if (!mBuffer.empty()) {
+        mOut.write(reinterpret_cast<const char*>(mBuffer.data()), static_cast<std::streamsize>(mBuffer.size()));
+        mBuffer.clear();
+    }
+}
+
+bool ReplayReader::open(const std::string& path) {
+    mIn.close();
+    mIn.clear();
+    mIn.open(path, std::ios::binary);
+    mBuffer.resize(BufferSize);
+    mPos = 0;
+    mSize = 0;
+    mRunDirection = Direction::None;
+    mRunRemaining = 0;
+    mTicksRead = 0;
+    mEnded = true;
+
+    if (!mIn) {
+        PACMAN_LOG_ERROR("Failed to open replay: %s", path.c_str());
+        return false;
+    }
+
+    std::uint8_t header[6];
+    for (std::uint8_t& b : header) {
+        if (!readByte(b)) {
+            PACMAN_LOG_ERROR("Replay header truncated: %s", path.c_str());
+            return false;
+        }
+    }
+    if (!std::equal(std::begin(Magic), std::end(Magic), header) || header[4] != Version) {
+        PACMAN_LOG_ERROR("Not a replay file (or unsupported version): %s", path.c_str());
+        return false;
+    }
+    if (header[5] != buildFlags()) {
+        PACMAN_LOG_WARN("Replay was recorded with %s movement; playback may diverge",
+                        (header[5] & FlagFixedPoint) ? "fixed-point" : "float");
+    }
+
+    std::uint64_t seed = 0;
+    std::uint64_t pathLength = 0;
+    if (!readVarint(seed) || !readVarint(pathLength)) {
+        PACMAN_LOG_ERROR("Replay header truncated: %s", path.c_str());
+        return false;
+    }
+    mSeed = static_cast<std::uint32_t>(seed);
+
+    mMapPath.clear();
+    for (std::uint64_t i = 0; i < pathLength; ++i) {
+        std::uint8_t c = 0;
+        if (!readByte(c)) {
+            PACMAN_LOG_ERROR("Replay header truncated: %s", path.c_str());
+            return false;
+        }
+        mMapPath.push_back(static_cast<char>(c));
+    }
+
+    mEnded = false;
+    return true;
+}
+
+ReplayStep ReplayReader::next(Direction& requested) {
+    while (!mEnded) {
+        if (mRunRemaining > 0) {
+            --mRunRemaining;
+            ++mTicksRead;
+            requested = mRunDirection;
+            return ReplayStep::Tick;
+        }
+
+        std::uint64_t record = 0;
+        if (!readVarint(record)) {
+            PACMAN_LOG_ERROR("Replay truncated after %llu ticks", static_cast<unsigned long long>(mTicksRead));
+            mEnded = true;
+            break;
+        }
+
+        const std::uint64_t code = record & ((1u << CodeBits) - 1u);
+        const std::uint64_t count = record >> CodeBits;
+        if (code == CodeEnd) {
+            mEnded = true;
+        } else if (code == CodeNewGame) {
+            return ReplayStep::NewGame;
+        } else if (code <= static_cast<std::uint64_t>(Direction::Right) && count > 0) {
+            mRunDirection = static_cast<Direction>(code);
+            mRunRemaining = count;
+        } else {
+            PACMAN_LOG_ERROR("Corrupt replay record after %llu ticks", static_cast<unsigned long long>(mTicksRead));
+            mEnded = true;
+        }
+    }
+    return ReplayStep::End;
+}
+
+bool ReplayReader::readByte(std::uint8_t& out) {
+    if (mPos == mSize) {
+        mIn.read(reinterpret_cast<char*>(mBuffer.data()), static_cast<std::streamsize>(mBuffer.size()));
+        mSize = static_cast<std::size_t>(mIn.gcount());
+        mPos = 0;
+        if (mSize == 0) {
+            return false;
+        }
+    }
+    out = mBuffer[mPos++];
+    return true;
+}
+
+bool ReplayReader::readVarint(std::uint64_t& out) {
+    out = 0;
+    for (unsigned shift = 0; shift < 64; shift += 7) {
+        std::uint8_t b = 0;
+        if (!readByte(b)) {
+            return false;
+        }
+        out |= static_cast<std::uint64_t>(b & 0x7F) << shift;
+        if ((b & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "Types.h"
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Binary input replay.
+//
+// A replay is the seed the Simulation was started with plus the player's requested direction
+// at the start of every Simulation::update(). Replaying those ticks against a freshly seeded
+// Simulation reproduces the session exactly (use PACMAN_FIXED_POINT builds across machines).
+//
+// Layout: "PMRP", version byte, flags byte, varint seed, varint map path length, map path bytes,
+// then a stream of varint records `(count << 3) | code`:
+//   code 0-4  `count` consecutive ticks requesting that Direction
+//   code 6    startNewGame() was called (count is 0)
+//   code 7    end of stream
+// Input only changes a few times per second, so a run-length record is typically 2-3 bytes
+// per direction change. Both ends stream through a fixed buffer and never hold the whole file.
+class ReplayWriter {
+public:
+    ReplayWriter() = default;
+    ~ReplayWriter();
+
+    ReplayWriter(const ReplayWriter&) = delete;
+    ReplayWriter& operator=(const ReplayWriter&) = delete;
+
+    bool open(const std::string& path, std::uint32_t seed, const std::string& mapPath);
+    bool isOpen() const { return mOut.is_open(); }
+
+    // Called by Simulation at the start of every update() and from startNewGame().
+    void recordTick(Direction requested);
+    void recordNewGame();
+
+    // Writes the end marker and flushes. Returns false if any write failed.
+    bool close();
+
+private:
+    void flushRun();
+    void writeVarint(std::uint64_t value);
+    void flushBuffer();
+
+    std::ofstream mOut;
+    std::vector<std::uint8_t> mBuffer;
+    Direction mRunDirection = Direction::None;
+    std::uint64_t mRunLength = 0;
+};
+
+enum class ReplayStep : std::uint8_t {
+    Tick,
+    NewGame,
+    End,
+};
+
+class ReplayReader {
+public:
+    bool open(const std::string& path);
+
+    std::uint32_t seed() const { return mSeed; }
+    const std::string& mapPath() const { return mMapPath; }
+
+    // Next recorded step. For ReplayStep::Tick, `requested` is the direction to feed to
+    // Simulation::requestDirection() before the next update(). Truncated or corrupt streams end
+    // with ReplayStep::End after an error message.
+    ReplayStep next(Direction& requested);
+
+    std::uint64_t ticksRead() const { return mTicksRead; }
+
+private:
+    bool readByte(std::uint8_t& out);
+    bool readVarint(std::uint64_t& out);
+
+    std::ifstream mIn;
+    std::vector<std::uint8_t> mBuffer;
+    std::size_t mPos = 0;
+    std::size_t mSize = 0;
+
+    std::uint32_t mSeed = 0;
+    std::string mMapPath;
+
+    Direction mRunDirection = Direction::None;
+    std::uint64_t mRunRemaining = 0;
+    std::uint64_t mTicksRead = 0;
+    bool mEnded = true;
+};
@@ -0,0 +1,414 @@
+#include "Simulation.h"
+
+#include "AssetPack.h"
+#include "Direction.h"
+#include "Log.h"
+#include "Profiler.h"
+#include "Replay.h"
+#include "Snapshot.h"
+
+#include <algorithm>
+
+namespace {
+TileCoord clampToMap(TileCoord t, const Map& map) {
+    if (t.x < 0) t.x = 0;
+    if (t.y < 0) t.y = 0;
+    if (t.x >= map.width()) t.x = map.width() - 1;
+    if (t.y >= map.height()) t.y = map.height() - 1;
+    return t;
+}
+}
+
+Simulation::Simulation() {
+    mEvents.reserve(16);
+}
+
+void Simulation::setMapPaths(std::string primary, std::string fallback) {
+    mMapPath = std::move(primary);
+    mFallbackMapPath = std::move(fallback);
+    mMapLoaded = false;
+}
+
+bool Simulation::loadMap(const std::string& path) {
+    const AssetPack::Source source = AssetPack::resolve(mAssetPack, path);
+    if (source.packed) {
+        return mMap.loadFromMemory(source.packed.text(), path);
+    }
+    return mMap.loadFromFile(source.path);
+}
+
+void Simulation::startNewGame() {
+    if (mRecorder) {
+        mRecorder->recordNewGame();
+    }
+
+    mScore = 0;
+    mLives = 3;
+    mLevel = 1;
+    mGameOver = false;
+    mTick = 0;
+    mEvents.clear();
+    loadLevel(mLevel);
+}
+
+void Simulation::loadLevel(int level) {
+    (void)level;
+
+    // Every level replays the same maze: refill it in memory instead of re-reading the file
+    // in the middle of a tick.
+    if (!mMapLoaded || !mMap.restoreInitialCells()) {
+        if (!loadMap(mMapPath)) {
+            // Fallback: minimal map.
+            PACMAN_LOG_WARN("Using fallback map");
+            loadMap(mFallbackMapPath);
+        }
+        mMapLoaded = true;
+    }
+
+    // Build ghosts once.
+    if (mGhosts.empty()) {
+        mGhosts.emplace_back(GhostId::Blinky);
+        mGhosts.emplace_back(GhostId::Pinky);
+        mGhosts.emplace_back(GhostId::Inky);
+        mGhosts.emplace_back(GhostId::Clyde);
+    }
+
+    mModePhaseIndex = 0;
+    mModeTimer = 0.f;
+    mBaseMode = GhostMode::Scatter;
+
+    mDotsEatenThisLevel = 0;
+    mFruitActive = false;
+    mFruitSpawnedThisLevel = false;
+    mFruitTimer = 0.f;
+    mFruitTile = mMap.fruitSpawn();
+
+    resetEntities();
+}
+
+void Simulation::resetEntities() {
+    mPlayer.reset(mMap.playerSpawn(), mMap, mTileSize);
+
+    const TileCoord topLeft{1, 1};
+    const TileCoord topRight{mMap.width() - 2, 1};
+    const TileCoord bottomLeft{1, mMap.height() - 2};
+    const TileCoord bottomRight{mMap.width() - 2, mMap.height() - 2};
+
+    for (auto& g : mGhosts) {
+        TileCoord spawn = mMap.ghostSpawnBlinky();
+        TileCoord corner = topRight;
+
+        switch (g.id()) {
+        case GhostId::Blinky: spawn = mMap.ghostSpawnBlinky(); corner = topRight; break;
+        case GhostId::Pinky: spawn = mMap.ghostSpawnPinky(); corner = topLeft; break;
+        case GhostId::Inky: spawn = mMap.ghostSpawnInky(); corner = bottomRight; break;
+        case GhostId::Clyde: spawn = mMap.ghostSpawnClyde(); corner = bottomLeft; break;
+        }
+
+        g.reset(spawn, corner, mMap, mTileSize);
+        g.setSpeeds(mConfig.ghostSpeed, mConfig.frightenedGhostSpeed, mConfig.eatenGhostSpeed);
+        g.setMode(mBaseMode);
+    }
+
+    mFrightenedTimer = 0.f;
+    mFreezeTimer = 0.f;
+}
+
+void Simulation::updateGhostMode(float dt) {
+    PACMAN_ZONE("Simulation::updateGhostMode");
+    if (mFrightenedTimer > 0.f) {
+        mFrightenedTimer -= dt;
+        if (mFrightenedTimer <= 0.f) {
+            mFrightenedTimer = 0.f;
+            // Restore base mode.
+            setAllGhostModes(mBaseMode, false);
+        }
+        return; // Freeze scatter/chase schedule while frightened (classic behavior).
+    }
+
+    mModeTimer += dt;
+
+    const auto& phases = mConfig.modePhasesSeconds;
+    const float phaseLen = phases[std::min(mModePhaseIndex, phases.size() - 1)];
+    if (mModeTimer >= phaseLen) {
+        mModeTimer = 0.f;
+        mModePhaseIndex = std::min(mModePhaseIndex + 1, phases.size() - 1);
+
+        // Toggle Scatter <-> Chase.
+        mBaseMode = (mBaseMode == GhostMode::Scatter) ? GhostMode::Chase : GhostMode::Scatter;
+        setAllGhostModes(mBaseMode, true);
+    }
+}
+
+void Simulation::setAllGhostModes(GhostMode mode, bool reverse) {
+    for (auto& g : mGhosts) {
+        if (reverse) {
+            g.reverse();
+        }
+        // If the ghost is currently returning home (Eaten), leave it alone.
+        if (g.mode() != GhostMode::Eaten) {
+            g.setMode(mode);
+        }
+    }
+}
+
+TileCoord Simulation::chaseTargetFor(const Ghost& ghost) const {
+    const TileCoord pac = mPlayer.currentTile(mMap, mTileSize);
+
+    if (ghost.mode() == GhostMode::Scatter) {
+        return ghost.scatterCorner();
+    }
+
+    if (ghost.mode() == GhostMode::Eaten) {
+        return ghost.spawnTile();
+    }
+
+    // For Frightened we don't care; Ghost chooses random.
+    if (ghost.mode() == GhostMode::Frightened) {
+        return pac;
+    }
+
+    // Chase mode personalities.
+    const sf::Vector2i dir = dirToGridDelta(mPlayer.direction());
+
+    if (ghost.id() == GhostId::Blinky) {
+        return pac;
+    }
+
+    if (ghost.id() == GhostId::Pinky) {
+        TileCoord t{pac.x + 4 * dir.x, pac.y + 4 * dir.y};
+        return clampToMap(t, mMap);
+    }
+
+    if (ghost.id() == GhostId::Inky) {
+        const Ghost* blinky = nullptr;
+        for (const auto& g : mGhosts) {
+            if (g.id() == GhostId::Blinky) {
+                blinky = &g;
+                break;
+            }
+        }
+        const TileCoord twoAhead = clampToMap({pac.x + 2 * dir.x, pac.y + 2 * dir.y}, mMap);
+        if (!blinky) {
+            return twoAhead;
+        }
+        const TileCoord bTile = blinky->currentTile(mMap, mTileSize);
+        const TileCoord vec{twoAhead.x - bTile.x, twoAhead.y - bTile.y};
+        return clampToMap({bTile.x + 2 * vec.x, bTile.y + 2 * vec.y}, mMap);
+    }
+
+    // Clyde
+    const TileCoord cTile = ghost.currentTile(mMap, mTileSize);
+    const int dx = cTile.x - pac.x;
+    const int dy = cTile.y - pac.y;
+    const int d2 = dx * dx + dy * dy;
+    if (d2 > (8 * 8)) {
+        return pac;
+    }
+    return ghost.scatterCorner();
+}
+
+void Simulation::handlePlayerTile() {
+    const TileCoord t = mPlayer.currentTile(mMap, mTileSize);
+    const char c = mMap.cell(t.x, t.y);
+
+    if (c == '.') {
+        mScore += 10;
+        mDotsEatenThisLevel += 1;
+        mMap.setCell(t.x, t.y, ' ');
+        mEvents.push_back(SimEvent::DotEaten);
+    } else if (c == 'o') {
+        mScore += 50;
+        mDotsEatenThisLevel += 1;
+        mMap.setCell(t.x, t.y, ' ');
+        mEvents.push_back(SimEvent::PowerPelletEaten);
+
+        mFrightenedTimer = mConfig.frightenedSeconds;
+        for (auto& g : mGhosts) {
+            if (g.mode() != GhostMode::Eaten) {
+                g.setMode(GhostMode::Frightened);
+                g.reverse();
+            }
+        }
+    }
+}
+
+void Simulation::updateFruit(float dt) {
+    // Classic-inspired: spawn a bonus fruit once per level after enough dots.
+    if (!mFruitSpawnedThisLevel && mDotsEatenThisLevel >= mConfig.fruitDots) {
+        mFruitSpawnedThisLevel = true;
+        mFruitActive = true;
+        mFruitTimer = mConfig.fruitSeconds;
+    }
+
+    if (mFruitActive) {
+        mFruitTimer -= dt;
+        if (mFruitTimer <= 0.f) {
+            mFruitActive = false;
+            mFruitTimer = 0.f;
+        }
+
+        const TileCoord t = mPlayer.currentTile(mMap, mTileSize);
+        if (t == mFruitTile) {
+            mFruitActive = false;
+            mFruitTimer = 0.f;
+            mScore += 500;
+            mEvents.push_back(SimEvent::FruitEaten);
+        }
+    }
+}
+
+void Simulation::handleCollisions() {
+    PACMAN_ZONE("Simulation::handleCollisions");
+    constexpr float HitRadiusTiles = 0.55f;
+
+    for (auto& g : mGhosts) {
+        if (!g.mover().overlaps(mPlayer.mover(), HitRadiusTiles)) {
+            continue;
+        }
+
+        if (g.mode() == GhostMode::Frightened) {
+            mScore += 200;
+            g.setMode(GhostMode::Eaten);
+            mEvents.push_back(SimEvent::GhostEaten);
+            continue;
+        }
+
+        if (g.mode() == GhostMode::Eaten) {
+            continue;
+        }
+
+        // Player dies.
+        mLastKiller = g.id();
+        mLastKillerMode = g.mode();
+        mLives -= 1;
+        mEvents.push_back(SimEvent::PlayerDied);
+
+        if (mLives <= 0) {
+            mGameOver = true;
+            mEvents.push_back(SimEvent::GameOver);
+            return;
+        }
+
+        // Reset positions with a short freeze.
+        resetEntities();
+        mFreezeTimer = 0.8f;
+        return;
+    }
+}
+
+bool Simulation::saveSnapshot(SimSnapshot& out) const {
+    if (mMap.width() * mMap.height() > SimSnapshot::MaxTiles || mGhosts.size() > SimSnapshot::MaxGhosts) {
+        return false;
+    }
+
+    out.layoutRevision = mMap.layoutRevision();
+    out.tick = mTick;
+
+    out.player = mPlayer;
+    out.ghostCount = static_cast<std::uint8_t>(mGhosts.size());
+    std::copy(mGhosts.begin(), mGhosts.end(), out.ghosts.begin());
+
+    out.score = mScore;
+    out.lives = mLives;
+    out.level = mLevel;
+    out.gameOver = mGameOver;
+    out.lastKiller = mLastKiller;
+    out.lastKillerMode = mLastKillerMode;
+
+    out.dotsEatenThisLevel = mDotsEatenThisLevel;
+    out.fruitActive = mFruitActive;
+    out.fruitSpawnedThisLevel = mFruitSpawnedThisLevel;
+    out.fruitTimer = mFruitTimer;
+    out.fruitTile = mFruitTile;
+
+    out.baseMode = mBaseMode;
+    out.modeTimer = mModeTimer;
+    out.modePhaseIndex = static_cast<std::uint32_t>(mModePhaseIndex);
+    out.frightenedTimer = mFrightenedTimer;
+    out.freezeTimer = mFreezeTimer;
+
+    out.rng = mRng;
+
+    mMap.writePelletBits(out.dots.data(), out.powerPellets.data());
+    return true;
+}
+
+bool Simulation::restoreSnapshot(const SimSnapshot& in) {
+    if (in.layoutRevision != mMap.layoutRevision() || in.ghostCount != mGhosts.size()
+        || mMap.width() * mMap.height() > SimSnapshot::MaxTiles) {
+        return false;
+    }
+
+    mTick = in.tick;
+
+    mPlayer = in.player;
+    std::copy(in.ghosts.begin(), in.ghosts.begin() + in.ghostCount, mGhosts.begin());
+
+    mScore = in.score;
+    mLives = in.lives;
+    mLevel = in.level;
+    mGameOver = in.gameOver;
+    mLastKiller = in.lastKiller;
+    mLastKillerMode = in.lastKillerMode;
+
+    mDotsEatenThisLevel = in.dotsEatenThisLevel;
+    mFruitActive = in.fruitActive;
+    mFruitSpawnedThisLevel = in.fruitSpawnedThisLevel;
+    mFruitTimer = in.fruitTimer;
+    mFruitTile = in.fruitTile;
+
+    mBaseMode = in.baseMode;
+    mModeTimer = in.modeTimer;
+    mModePhaseIndex = in.modePhaseIndex;
+    mFrightenedTimer = in.frightenedTimer;
+    mFreezeTimer = in.freezeTimer;
+
+    mRng = in.rng;
+
+    mMap.readPelletBits(in.dots.data(), in.powerPellets.data());
+    mEvents.clear();
+    return true;
+}
+
+void Simulation::update(float dt) {
+    PACMAN_ZONE("Simulation::update");
+    mEvents.clear();
+
+    if (mRecorder) {
+        mRecorder->recordTick(mPlayer.requestedDirection());
+    }
+
+    if (mGameOver) {
+        return;
+    }
+
+    ++mTick;
+
+    if (mFreezeTimer > 0.f) {
+        mFreezeTimer -= dt;
+        if (mFreezeTimer < 0.f) mFreezeTimer = 0.f;
+        return;
+    }
+
+    updateGhostMode(dt);
+
+    mPlayer.update(dt, mMap, mTileSize);
+    handlePlayerTile();
+    updateFruit(dt);
+
+    // Update ghosts
+    mFlowFields.beginTick(mMap);
+    for (auto& g : mGhosts) {
+        const TileCoord target = chaseTargetFor(g);
+        g.update(dt, mMap, mTileSize, target, mRng, mFlowFields);
+    }
+
+    handleCollisions();
+
+    if (!mMap.hasDotsOrPellets()) {
+        mLevel += 1;
+        mEvents.push_back(SimEvent::LevelCleared);
+        loadLevel(mLevel);
+    }
+}
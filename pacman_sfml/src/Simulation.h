@@ -0,0 +1,163 @@
+#pragma once
+
+#include "FlowField.h"
+#include "Ghost.h"
+#include "Map.h"
+#include "Player.h"
+
+#include <array>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+class AssetPack;
+class ReplayWriter;
+struct SimSnapshot;
+
+// Gameplay notifications for the presentation layer (sounds, logging, ...).
+// The simulation itself never touches audio or rendering.
+enum class SimEvent : std::uint8_t {
+    DotEaten,
+    PowerPelletEaten,
+    FruitEaten,
+    GhostEaten,
+    PlayerDied,
+    GameOver,
+    LevelCleared,
+};
+
+// Gameplay tuning that stays fixed while games run. The defaults are what the game ships with;
+// pacman_batch overrides them to compare balance changes. Replays assume the defaults.
+struct SimConfig {
+    // Scatter/Chase alternate starting with Scatter; the last phase lasts for the rest of the level.
+    std::array<float, 8> modePhasesSeconds{7.f, 20.f, 7.f, 20.f, 5.f, 20.f, 5.f, 9999.f};
+    float frightenedSeconds = 6.f;
+
+    // Tiles per second.
+    float ghostSpeed = 7.f;
+    float frightenedGhostSpeed = 4.f;
+    float eatenGhostSpeed = 8.5f;
+
+    // One bonus fruit per level, shown after this many dots for this long.
+    int fruitDots = 50;
+    float fruitSeconds = 10.f;
+};
+
+// Window-free gameplay state: maze, Pac-Man, ghosts, scoring, mode timers, fruit and RNG.
+// Advanced in fixed steps by Game (windowed) or pacman_sim (headless).
+class Simulation {
+public:
+    static constexpr float FixedDt = 1.f / static_cast<float>(GridMover::StepsPerSecond);
+
+    Simulation();
+
+    void setMapPaths(std::string primary, std::string fallback);
+    const std::string& mapPath() const { return mMapPath; }
+    const std::string& fallbackMapPath() const { return mFallbackMapPath; }
+    // Map paths found in the pack load from its mapped bytes; others still load from disk.
+    // Not owned; null reads loose files only.
+    void setAssetPack(const AssetPack* pack) { mAssetPack = pack; mMapLoaded = false; }
+    // Plays on a copy of an already loaded maze instead of loading mapPath(). The copy shares
+    // the source's NavTable, so many simulations on one layout build and hold it once.
+    void setMap(const Map& map) { mMap = map; mMapLoaded = true; }
+    void seed(std::uint32_t seed) { mRng.seed(seed); }
+
+    // Takes effect from the next startNewGame() / loadLevel().
+    void setConfig(const SimConfig& config) { mConfig = config; }
+    const SimConfig& config() const { return mConfig; }
+
+    // Optional input recorder; every update() and startNewGame() is logged to it. Not owned.
+    void setRecorder(ReplayWriter* recorder) { mRecorder = recorder; }
+
+    void startNewGame();
+    void loadLevel(int level);
+
+    void requestDirection(Direction d) { mPlayer.requestDirection(d); }
+    void update(float dt);
+
+    // Copy the full mutable state into / out of a flat block (see Snapshot.h). Both fail when the
+    // maze is larger than SimSnapshot::MaxTiles; restore also fails on a different maze layout.
+    bool saveSnapshot(SimSnapshot& out) const;
+    bool restoreSnapshot(const SimSnapshot& in);
+
+    bool isGameOver() const { return mGameOver; }
+    std::uint64_t tick() const { return mTick; }
+
+    // Events raised during the most recent update().
+    const std::vector<SimEvent>& events() const { return mEvents; }
+
+    const Map& map() const { return mMap; }
+    const Player& player() const { return mPlayer; }
+    const std::vector<Ghost>& ghosts() const { return mGhosts; }
+
+    float tileSize() const { return mTileSize; }
+
+    int score() const { return mScore; }
+    int lives() const { return mLives; }
+    int level() const { return mLevel; }
+
+    // Ghost (and its mode) that caused the most recent SimEvent::PlayerDied.
+    GhostId lastKiller() const { return mLastKiller; }
+    GhostMode lastKillerMode() const { return mLastKillerMode; }
+
+    bool fruitActive() const { return mFruitActive; }
+    TileCoord fruitTile() const { return mFruitTile; }
+
+private:
+    void resetEntities();
+
+    void updateGhostMode(float dt);
+    void setAllGhostModes(GhostMode mode, bool reverse);
+
+    void handlePlayerTile();
+    void updateFruit(float dt);
+    void handleCollisions();
+
+    TileCoord chaseTargetFor(const Ghost& ghost) const;
+    bool loadMap(const std::string& path);
+
+    std::string mMapPath = "assets/maps/level1.txt";
+    std::string mFallbackMapPath = "assets/maps/fallback.txt";
+    bool mMapLoaded = false;
+    const AssetPack* mAssetPack = nullptr;
+
+    Map mMap;
+    Player mPlayer;
+    std::vector<Ghost> mGhosts;
+    FlowFieldCache mFlowFields;
+
+    float mTileSize = 8.f;
+    SimConfig mConfig;
+
+    int mScore = 0;
+    int mLives = 3;
+    int mLevel = 1;
+    bool mGameOver = false;
+
+    std::uint64_t mTick = 0;
+    std::vector<SimEvent> mEvents;
+
+    int mDotsEatenThisLevel = 0;
+
+    bool mFruitActive = false;
+    bool mFruitSpawnedThisLevel = false;
+    float mFruitTimer = 0.f;
+    TileCoord mFruitTile{0, 0};
+
+    // Position in SimConfig::modePhasesSeconds.
+    GhostMode mBaseMode = GhostMode::Scatter;
+    float mModeTimer = 0.f;
+    std::size_t mModePhaseIndex = 0;
+
+    // Frightened
+    float mFrightenedTimer = 0.f;
+
+    // Death / reset pacing
+    float mFreezeTimer = 0.f;
+    GhostId mLastKiller = GhostId::Blinky;
+    GhostMode mLastKillerMode = GhostMode::Scatter;
+
+    std::mt19937 mRng;
+    ReplayWriter* mRecorder = nullptr;
+};
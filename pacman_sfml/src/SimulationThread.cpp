@@ -0,0 +1,191 @@
+#include "SimulationThread.h"
+
+#include "AllocationCounter.h"
+#include "Log.h"
+#include "Profiler.h"
+
+namespace {
+// After a stall this long (debugger, suspended laptop) the missed ticks are dropped, not replayed.
+constexpr auto MaxBacklog = std::chrono::milliseconds(250);
+}
+
+void RenderSnapshotBuilder::beforeTick(const Simulation& sim) {
+    mTickStart = std::chrono::steady_clock::now();
+    mTickAllocationsStart = AllocationCounter::thisThread();
+    mPreviousPlayer = sim.player().position();
+    const auto& ghosts = sim.ghosts();
+    for (std::size_t i = 0; i < ghosts.size() && i < mPreviousGhosts.size(); ++i) {
+        mPreviousGhosts[i] = ghosts[i].position();
+    }
+}
+
+void RenderSnapshotBuilder::afterTick(const Simulation& sim) {
+    mSimTime += std::chrono::steady_clock::now() - mTickStart;
+    mSimAllocations += AllocationCounter::thisThread() - mTickAllocationsStart;
+    ++mTicksRun;
+    for (SimEvent e : sim.events()) {
+        ++mEventCounts[static_cast<std::size_t>(e)];
+    }
+}
+
+bool RenderSnapshotBuilder::build(const Simulation& sim, RenderSnapshot& out, std::chrono::steady_clock::time_point tickTime) {
+    out.valid = false;
+    if (!sim.saveSnapshot(out.state)) {
+        return false;
+    }
+
+    // Copying the maze allocates, so only do it when the walls actually changed.
+    if (!mLayout || mLayoutRevision != sim.map().layoutRevision()) {
+        mLayout = std::make_shared<const Map>(sim.map());
+        mLayoutRevision = sim.map().layoutRevision();
+    }
+
+    out.layout = mLayout;
+    out.tileSize = sim.tileSize();
+    out.previousPlayerPosition = mPreviousPlayer;
+    out.previousGhostPositions = mPreviousGhosts;
+    out.eventCounts = mEventCounts;
+    out.tickTime = tickTime;
+    out.ticksRun = mTicksRun;
+    out.simTime = mSimTime;
+    out.simAllocations = mSimAllocations;
+    out.valid = true;
+    return true;
+}
+
+SimulationThread::~SimulationThread() {
+    stop();
+}
+
+void SimulationThread::start() {
+    if (running()) {
+        return;
+    }
+    mStopping.store(false);
+    mThread = std::thread([this] { run(); });
+}
+
+void SimulationThread::stop() {
+    if (!running()) {
+        return;
+    }
+    mStopping.store(true);
+    wake();
+    mThread.join();
+}
+
+void SimulationThread::setActive(bool active) {
+    if (mActive.exchange(active) != active) {
+        wake();
+    }
+}
+
+bool SimulationThread::pushInput(InputSource source, Direction d, std::chrono::steady_clock::time_point time, bool repeat) {
+    InputQueue& queue = (source == InputSource::Controller) ? mControllerInput : mWindowInput;
+    return queue.push(InputEvent{time, d, repeat});
+}
+
+void SimulationThread::applyInputUpTo(std::chrono::steady_clock::time_point deadline) {
+    // Merge the per-source queues by timestamp; later requests overwrite earlier ones.
+    for (;;) {
+        const InputEvent* window = mWindowInput.front();
+        const InputEvent* controller = mControllerInput.front();
+        if (window != nullptr && window->time > deadline) {
+            window = nullptr;
+        }
+        if (controller != nullptr && controller->time > deadline) {
+            controller = nullptr;
+        }
+        if (window == nullptr && controller == nullptr) {
+            return;
+        }
+
+        const bool takeWindow = (controller == nullptr) || (window != nullptr && window->time <= controller->time);
+        InputQueue& queue = takeWindow ? mWindowInput : mControllerInput;
+        const InputEvent e = *queue.front();
+        queue.pop();
+        mSim.requestDirection(e.direction);
+
+        if (mTracing && !e.repeat && !mTrace.push(AppliedInput{e.time, std::chrono::steady_clock::now(), mBuilder.ticksRun() + 1})) {
+            mTraceDropped.fetch_add(1);
+        }
+    }
+}
+
+void SimulationThread::discardInputUpTo(std::chrono::steady_clock::time_point deadline) {
+    for (InputQueue* queue : {&mWindowInput, &mControllerInput}) {
+        for (const InputEvent* e = queue->front(); e != nullptr && e->time <= deadline; e = queue->front()) {
+            queue->pop();
+        }
+    }
+}
+
+void SimulationThread::requestNewGame() {
+    mNewGameRequests.fetch_add(1);
+    wake();
+}
+
+void SimulationThread::wake() {
+    // Taking the lock orders the notify after a worker that just checked its predicate.
+    std::lock_guard<std::mutex> lock(mWakeMutex);
+    mWake.notify_one();
+}
+
+bool SimulationThread::publish(std::chrono::steady_clock::time_point tickTime) {
+    if (!mBuilder.build(mSim, mSnapshots.writeBuffer(), tickTime)) {
+        return false;
+    }
+    mSnapshots.publish();
+    mTicksRun.store(mBuilder.ticksRun(), std::memory_order_relaxed);
+    return true;
+}
+
+void SimulationThread::run() {
+    using Clock = std::chrono::steady_clock;
+    const auto step = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(Simulation::FixedDt));
+
+    Profiler::setThreadName("simulation");
+    Log::setThreadName("simulation");
+
+    std::uint32_t newGamesHandled = mNewGameRequests.load();
+    mBuilder.beforeTick(mSim);
+    Clock::time_point next = Clock::now();
+    if (!publish(next)) {
+        PACMAN_LOG_ERROR("Maze too large for render snapshots (max %d tiles)", SimSnapshot::MaxTiles);
+    }
+
+    while (!mStopping.load()) {
+        const std::uint32_t newGames = mNewGameRequests.load();
+        if (newGames != newGamesHandled) {
+            newGamesHandled = newGames;
+            next = Clock::now();
+            // Input from the previous game must not steer the new one.
+            discardInputUpTo(next);
+            mSim.startNewGame();
+            mBuilder.beforeTick(mSim);
+            publish(next);
+        }
+
+        if (!mActive.load()) {
+            std::unique_lock<std::mutex> lock(mWakeMutex);
+            mWake.wait(lock, [&] { return mStopping.load() || mActive.load() || mNewGameRequests.load() != newGamesHandled; });
+            next = Clock::now();
+            continue;
+        }
+
+        next += step;
+        std::this_thread::sleep_until(next);
+        const Clock::time_point now = Clock::now();
+        if (now - next > MaxBacklog) {
+            next = now;
+        }
+
+        PACMAN_ZONE("SimulationThread::tick");
+        applyInputUpTo(next);
+
+        mBuilder.beforeTick(mSim);
+        mSim.update(Simulation::FixedDt);
+        mBuilder.afterTick(mSim);
+        publish(next);
+    }
+}
@@ -0,0 +1,166 @@
+#pragma once
+
+#include "Simulation.h"
+#include "Snapshot.h"
+#include "SpscQueue.h"
+#include "TripleBuffer.h"
+
+#include <SFML/System/Vector2.hpp>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+constexpr std::size_t SimEventKindCount = static_cast<std::size_t>(SimEvent::LevelCleared) + 1;
+
+// Everything the presentation side needs to draw one simulation tick, detached from the
+// Simulation so it can be read on another thread.
+struct RenderSnapshot {
+    bool valid = false;
+    SimSnapshot state;
+
+    // Maze the state belongs to. Immutable and shared; only replaced when the layout changes,
+    // the pellets come from state.dots / state.powerPellets.
+    std::shared_ptr<const Map> layout;
+    float tileSize = 8.f;
+
+    // Entity positions one tick earlier, for render interpolation.
+    sf::Vector2f previousPlayerPosition{0.f, 0.f};
+    std::array<sf::Vector2f, SimSnapshot::MaxGhosts> previousGhostPositions{};
+
+    // Running totals per SimEvent kind. Unlike per-tick event lists these survive snapshots
+    // the reader never sees: a total that went up means the event happened.
+    std::array<std::uint32_t, SimEventKindCount> eventCounts{};
+
+    // Wall-clock deadline of the tick this state is the result of.
+    std::chrono::steady_clock::time_point tickTime{};
+    // Ticks simulated since the builder was created; unlike state.tick it never resets.
+    std::uint64_t ticksRun = 0;
+    // Time spent inside those ticks (update() alone), for the performance overlay.
+    std::chrono::steady_clock::duration simTime{};
+    // Heap allocations made inside those ticks; zero growth is the steady-state goal.
+    std::uint64_t simAllocations = 0;
+};
+
+// A direction request stamped with the moment it was sampled.
+struct InputEvent {
+    std::chrono::steady_clock::time_point time{};
+    Direction direction = Direction::None;
+    // Re-sent while a stick is held rather than a new press; never traced for latency.
+    bool repeat = false;
+};
+
+// Where input comes from. Each source has its own queue and must feed it from a single thread.
+enum class InputSource : std::uint8_t {
+    Window,     // window events, polled on the main thread
+    Controller, // joystick, polled on its own thread
+};
+
+// Latency tracing record: an input, when a tick picked it up, and the first tick (in
+// RenderSnapshot::ticksRun terms) whose state reflects it.
+struct AppliedInput {
+    std::chrono::steady_clock::time_point inputTime{};
+    std::chrono::steady_clock::time_point appliedAt{};
+    std::uint64_t visibleFromTick = 0;
+};
+
+// Produces RenderSnapshots from a Simulation. Call beforeTick()/afterTick() around every
+// update() (beforeTick() also after startNewGame()), and build() whenever a snapshot is due.
+class RenderSnapshotBuilder {
+public:
+    void beforeTick(const Simulation& sim);
+    void afterTick(const Simulation& sim);
+    std::uint64_t ticksRun() const { return mTicksRun; }
+
+    // Fails (and leaves `out` invalid) for mazes larger than SimSnapshot::MaxTiles.
+    bool build(const Simulation& sim, RenderSnapshot& out, std::chrono::steady_clock::time_point tickTime);
+
+private:
+    sf::Vector2f mPreviousPlayer{0.f, 0.f};
+    std::array<sf::Vector2f, SimSnapshot::MaxGhosts> mPreviousGhosts{};
+    std::array<std::uint32_t, SimEventKindCount> mEventCounts{};
+    std::uint64_t mTicksRun = 0;
+    std::chrono::steady_clock::time_point mTickStart{};
+    std::chrono::steady_clock::duration mSimTime{};
+    std::uint64_t mTickAllocationsStart = 0;
+    std::uint64_t mSimAllocations = 0;
+
+    std::shared_ptr<const Map> mLayout;
+    std::uint32_t mLayoutRevision = 0;
+};
+
+// Runs a Simulation at a fixed 60 Hz on its own thread, so presentation stalls (vsync, driver
+// hiccups) never delay a tick. Every tick is published as a RenderSnapshot through a triple
+// buffer; the owning thread picks up the newest one with acquire().
+//
+// While running, the Simulation belongs to the worker: the owner must not touch it until stop().
+class SimulationThread {
+public:
+    explicit SimulationThread(Simulation& sim) : mSim(sim) {}
+    ~SimulationThread();
+
+    SimulationThread(const SimulationThread&) = delete;
+    SimulationThread& operator=(const SimulationThread&) = delete;
+
+    void start();
+    void stop();
+    bool running() const { return mThread.joinable(); }
+
+    // Controls for the owning thread; picked up before the next tick. Ticks only run while active.
+    void setActive(bool active);
+    void requestNewGame();
+
+    // Queues a direction request. Each tick applies, in timestamp order, exactly the requests
+    // stamped at or before its deadline, so a turn lands on the same tick whatever the frame
+    // rate or polling phase. Returns false (request dropped) when that source's queue is full.
+    // `repeat` marks a re-send of a held input, which input tracing skips.
+    bool pushInput(InputSource source, Direction d, std::chrono::steady_clock::time_point time, bool repeat = false);
+
+    // Latency instrumentation; enable before start(). Every applied input is then reported to
+    // the owning thread, which pops them once the frame showing visibleFromTick is on screen.
+    void setInputTracing(bool enabled) { mTracing = enabled; }
+    const AppliedInput* tracedInput() { return mTrace.front(); }
+    void popTracedInput() { mTrace.pop(); }
+    // Trace records lost because the owner fell more than the queue capacity behind.
+    std::uint64_t droppedTraces() const { return mTraceDropped.load(); }
+
+    // RenderSnapshot::ticksRun of the newest published snapshot. Safe to read from any thread.
+    std::uint64_t ticksRun() const { return mTicksRun.load(std::memory_order_relaxed); }
+
+    // Swaps in the newest published snapshot; true when it is newer than the last one.
+    bool acquire() { return mSnapshots.acquire(); }
+    const RenderSnapshot& snapshot() const { return mSnapshots.readBuffer(); }
+
+private:
+    using InputQueue = SpscQueue<InputEvent, 256>;
+
+    void run();
+    void applyInputUpTo(std::chrono::steady_clock::time_point deadline);
+    void discardInputUpTo(std::chrono::steady_clock::time_point deadline);
+    bool publish(std::chrono::steady_clock::time_point tickTime);
+    void wake();
+
+    Simulation& mSim;
+    RenderSnapshotBuilder mBuilder;
+    TripleBuffer<RenderSnapshot> mSnapshots;
+
+    std::thread mThread;
+    std::mutex mWakeMutex;
+    std::condition_variable mWake;
+
+    std::atomic<bool> mStopping{false};
+    std::atomic<bool> mActive{false};
+    InputQueue mWindowInput;
+    InputQueue mControllerInput;
+
+    bool mTracing = false;
+    SpscQueue<AppliedInput, 1024> mTrace;
+    std::atomic<std::uint64_t> mTraceDropped{0};
+    std::atomic<std::uint32_t> mNewGameRequests{0};
+    std::atomic<std::uint64_t> mTicksRun{0};
+};
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "Ghost.h"
+#include "Player.h"
+#include "Types.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+// Complete mutable state of a Simulation in one flat, trivially copyable block: entities,
+// timers, score, the RNG and the pellet layer. Saving and restoring never allocates, and a
+// snapshot can be memcpy'd anywhere (ring buffers, worker threads, files within one build).
+//
+// The maze layout itself is not stored; a snapshot only restores onto the layout revision it
+// was taken from. Pellets are kept as bitsets, so mazes above MaxTiles cannot be snapshotted.
+struct SimSnapshot {
+    static constexpr int MaxTiles = 64 * 64;
+    static constexpr std::size_t PelletWords = MaxTiles / 64;
+    static constexpr std::size_t MaxGhosts = 4;
+
+    std::uint32_t layoutRevision = 0;
+    std::uint64_t tick = 0;
+
+    Player player;
+    std::array<Ghost, MaxGhosts> ghosts;
+    std::uint8_t ghostCount = 0;
+
+    int score = 0;
+    int lives = 0;
+    int level = 0;
+    bool gameOver = false;
+    GhostId lastKiller = GhostId::Blinky;
+    GhostMode lastKillerMode = GhostMode::Scatter;
+
+    int dotsEatenThisLevel = 0;
+    bool fruitActive = false;
+    bool fruitSpawnedThisLevel = false;
+    float fruitTimer = 0.f;
+    TileCoord fruitTile{0, 0};
+
+    GhostMode baseMode = GhostMode::Scatter;
+    float modeTimer = 0.f;
+    std::uint32_t modePhaseIndex = 0;
+    float frightenedTimer = 0.f;
+    float freezeTimer = 0.f;
+
+    std::mt19937 rng;
+
+    // Row-major bit per tile: a dot / a power pellet is present.
+    std::array<std::uint64_t, PelletWords> dots{};
+    std::array<std::uint64_t, PelletWords> powerPellets{};
+};
+
+static_assert(std::is_trivially_copyable<std::mt19937>::value, "SimSnapshot stores the engine by value");
+static_assert(std::is_trivially_copyable<SimSnapshot>::value, "SimSnapshot must stay memcpy-able");
+
+// Fixed-capacity ring of snapshots, allocated once. push() hands out the slot to fill, so a
+// save is a single Simulation::saveSnapshot() write with no copy and no allocation.
+class SnapshotRing {
+public:
+    explicit SnapshotRing(std::size_t capacity) : mSlots(capacity == 0 ? 1 : capacity) {}
+
+    // Slot for the newest snapshot; overwrites the oldest one when full.
+    SimSnapshot& push() {
+        mHead = (mHead + 1) % mSlots.size();
+        if (mCount < mSlots.size()) {
+            ++mCount;
+        }
+        return mSlots[mHead];
+    }
+
+    // Drops the newest snapshot (e.g. one taken but not needed after all).
+    void pop() {
+        if (mCount == 0) {
+            return;
+        }
+        mHead = (mHead + mSlots.size() - 1) % mSlots.size();
+        --mCount;
+    }
+
+    // `age` 0 is the newest snapshot; requires age < size().
+    const SimSnapshot& fromNewest(std::size_t age) const {
+        return mSlots[(mHead + mSlots.size() - age) % mSlots.size()];
+    }
+
+    std::size_t size() const { return mCount; }
+    std::size_t capacity() const { return mSlots.size(); }
+    void clear() { mCount = 0; }
+
+private:
+    std::vector<SimSnapshot> mSlots;
+    std::size_t mHead = 0;
+    std::size_t mCount = 0;
+};
@@ -1,76 +1,238 @@
 #include "SpriteAtlas.h"
 
+#include "Log.h"
+
 #include <nlohmann/json.hpp>
 
+#include <algorithm>
+#include <cmath>
 #include <fstream>
-#include <iostream>
+#include <iterator>
+
+namespace {
+// Transparent gap between packed frames so neighbours never bleed into each other.
+constexpr unsigned Padding = 1;
+
+unsigned nextPowerOfTwo(unsigned v) {
+    unsigned p = 1;
+    while (p < v) {
+        p <<= 1;
+    }
+    return p;
+}
+
+// Copies `rect` out of the keyed sheet; false (with a warning) when it does not fit.
+bool cutFrame(const sf::Image& sheet, const std::string& id, const sf::IntRect& rect, const std::string& name,
+              std::vector<SpriteAtlas::Frame>& frames) {
+    const sf::IntRect bounds(0, 0, static_cast<int>(sheet.getSize().x), static_cast<int>(sheet.getSize().y));
+    sf::IntRect clipped;
+    if (rect.width <= 0 || rect.height <= 0 || !bounds.intersects(rect, clipped) || clipped != rect) {
+        PACMAN_LOG_WARN("Atlas frame '%s' lies outside %s, skipping", id.c_str(), name.c_str());
+        return false;
+    }
+
+    SpriteAtlas::Frame frame{id, sf::Image()};
+    frame.image.create(static_cast<unsigned>(rect.width), static_cast<unsigned>(rect.height), sf::Color::Transparent);
+    frame.image.copy(sheet, 0, 0, rect);
+    frames.push_back(std::move(frame));
+    return true;
+}
+}
+
+SpriteAtlas::SpriteAtlas() {
+    mBuiltinHandles.fill(InvalidSprite);
+}
 
 bool SpriteAtlas::loadFromFiles(const std::string& imagePath, const std::string& jsonPath) {
-    mFrames.clear();
+    std::vector<Frame> frames;
+    return readSheet(imagePath, jsonPath, frames) && addFrames(frames);
+}
 
+bool SpriteAtlas::readSheet(const std::string& imagePath, const std::string& jsonPath, std::vector<Frame>& frames) {
     sf::Image img;
     if (!img.loadFromFile(imagePath)) {
-        std::cerr << "Failed to load atlas image: " << imagePath << "\n";
+        PACMAN_LOG_ERROR("Failed to load atlas image: %s", imagePath.c_str());
         return false;
     }
+
+    std::ifstream in(jsonPath, std::ios::binary);
+    if (!in) {
+        PACMAN_LOG_ERROR("Failed to open atlas json: %s", jsonPath.c_str());
+        return false;
+    }
+    const std::string json((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    return readSheet(img, json, imagePath, frames);
+}
+
+bool SpriteAtlas::readSheet(sf::Image& img, std::string_view json, const std::string& name, std::vector<Frame>& frames) {
     // Treat black as transparent to remove solid backgrounds in atlas BMP.
     img.createMaskFromColor(sf::Color::Black);
 
-    if (!mTexture.loadFromImage(img)) {
-        std::cerr << "Failed to create atlas texture from image: " << imagePath << "\n";
-        return false;
+    if (json == AtlasFrameSource) {
+        for (const AtlasFrameRect& f : AtlasFrameRects) {
+            cutFrame(img, std::string(f.name), sf::IntRect(f.x, f.y, f.w, f.h), name, frames);
+        }
+    } else {
+        PACMAN_LOG_INFO("[Atlas] %s differs from the built-in atlas.json, parsing it", name.c_str());
+        // No exceptions: this runs on loader threads.
+        const nlohmann::json j = nlohmann::json::parse(json.begin(), json.end(), nullptr, false);
+        if (j.is_discarded() || !j.contains("frames") || !j["frames"].is_object()) {
+            PACMAN_LOG_ERROR("Atlas JSON missing 'frames' object: %s", name.c_str());
+            return false;
+        }
+
+        for (auto it = j["frames"].begin(); it != j["frames"].end(); ++it) {
+            const auto& f = it.value();
+            // get<int>() would throw on anything else.
+            const auto isInt = [&f](const char* key) { return f.contains(key) && f[key].is_number_integer(); };
+            if (isInt("x") && isInt("y") && isInt("w") && isInt("h")) {
+                cutFrame(img, it.key(), sf::IntRect(f["x"].get<int>(), f["y"].get<int>(), f["w"].get<int>(), f["h"].get<int>()),
+                         name, frames);
+            }
+        }
     }
-    mTexture.setSmooth(false);
 
-    std::ifstream in(jsonPath);
-    if (!in) {
-        std::cerr << "Failed to open atlas json: " << jsonPath << "\n";
+    if (frames.empty()) {
+        PACMAN_LOG_ERROR("Atlas JSON contained no frames: %s", name.c_str());
         return false;
     }
+    return true;
+}
 
-    nlohmann::json j;
-    in >> j;
+bool SpriteAtlas::addFrames(const std::vector<Frame>& frames) {
+    for (const Frame& frame : frames) {
+        if (addImage(frame.id, frame.image) == InvalidSprite) {
+            PACMAN_LOG_ERROR("Atlas has too many frames, ignoring the rest");
+            break;
+        }
+    }
+    return pack();
+}
 
-    if (!j.contains("frames") || !j["frames"].is_object()) {
-        std::cerr << "Atlas JSON missing 'frames' object: " << jsonPath << "\n";
-        return false;
+SpriteHandle SpriteAtlas::addImage(const std::string& id, const sf::Image& image) {
+    const auto it = mHandles.find(id);
+    if (it != mHandles.end()) {
+        mImages[it->second] = image;
+        return it->second;
+    }
+    if (mImages.size() >= InvalidSprite) {
+        return InvalidSprite;
     }
 
-    for (auto it = j["frames"].begin(); it != j["frames"].end(); ++it) {
-        const std::string id = it.key();
-        const auto& f = it.value();
-        if (!f.contains("x") || !f.contains("y") || !f.contains("w") || !f.contains("h")) {
-            continue;
+    const SpriteHandle handle = static_cast<SpriteHandle>(mImages.size());
+    mHandles.emplace(id, handle);
+    for (std::size_t i = 0; i < AtlasFrameCount; ++i) {
+        if (AtlasFrameRects[i].name == id) {
+            mBuiltinHandles[i] = handle;
         }
+    }
+    mImages.push_back(image);
+    mFrameRects.emplace_back();
+    return handle;
+}
 
-        const int x = f["x"].get<int>();
-        const int y = f["y"].get<int>();
-        const int w = f["w"].get<int>();
-        const int h = f["h"].get<int>();
-        mFrames.emplace(id, sf::IntRect(x, y, w, h));
+bool SpriteAtlas::pack() {
+    if (mImages.empty()) {
+        return false;
+    }
+
+    // Tallest first keeps the shelves tight.
+    std::vector<SpriteHandle> order(mImages.size());
+    unsigned widest = 0;
+    std::size_t area = 0;
+    for (std::size_t i = 0; i < mImages.size(); ++i) {
+        order[i] = static_cast<SpriteHandle>(i);
+        const sf::Vector2u sz = mImages[i].getSize();
+        widest = std::max(widest, sz.x + Padding);
+        area += static_cast<std::size_t>(sz.x + Padding) * (sz.y + Padding);
+    }
+    std::stable_sort(order.begin(), order.end(), [this](SpriteHandle a, SpriteHandle b) {
+        return mImages[a].getSize().y > mImages[b].getSize().y;
+    });
+
+    const unsigned width = nextPowerOfTwo(std::max(widest, static_cast<unsigned>(std::ceil(std::sqrt(static_cast<double>(area))))));
+    unsigned x = 0;
+    unsigned y = 0;
+    unsigned shelfHeight = 0;
+    for (SpriteHandle h : order) {
+        const sf::Vector2u sz = mImages[h].getSize();
+        if (x + sz.x + Padding > width) {
+            x = 0;
+            y += shelfHeight;
+            shelfHeight = 0;
+        }
+        mFrameRects[h] = sf::IntRect(static_cast<int>(x), static_cast<int>(y), static_cast<int>(sz.x), static_cast<int>(sz.y));
+        x += sz.x + Padding;
+        shelfHeight = std::max(shelfHeight, sz.y + Padding);
     }
+    const unsigned height = nextPowerOfTwo(std::max(y + shelfHeight, 1u));
 
-    if (mFrames.empty()) {
-        std::cerr << "Atlas JSON contained no frames: " << jsonPath << "\n";
+    if (width > sf::Texture::getMaximumSize() || height > sf::Texture::getMaximumSize()) {
+        PACMAN_LOG_ERROR("Atlas needs %ux%u pixels, above the GPU limit of %u", width, height,
+                         sf::Texture::getMaximumSize());
         return false;
     }
 
+    sf::Image sheet;
+    sheet.create(width, height, sf::Color::Transparent);
+    for (std::size_t i = 0; i < mImages.size(); ++i) {
+        sheet.copy(mImages[i], static_cast<unsigned>(mFrameRects[i].left), static_cast<unsigned>(mFrameRects[i].top));
+    }
+
+    if (!mTexture.loadFromImage(sheet)) {
+        PACMAN_LOG_ERROR("Failed to create atlas texture (%ux%u)", width, height);
+        return false;
+    }
+    mTexture.setSmooth(false);
     return true;
 }
 
+SpriteHandle SpriteAtlas::find(const std::string& id) const {
+    const auto it = mHandles.find(id);
+    return (it != mHandles.end()) ? it->second : InvalidSprite;
+}
+
 bool SpriteAtlas::has(const std::string& id) const {
-    return mFrames.find(id) != mFrames.end();
+    return find(id) != InvalidSprite;
 }
 
 sf::Sprite SpriteAtlas::makeSprite(const std::string& id) const {
     sf::Sprite s;
     s.setTexture(mTexture);
 
-    const auto it = mFrames.find(id);
-    if (it != mFrames.end()) {
-        s.setTextureRect(it->second);
-        s.setOrigin(it->second.width * 0.5f, it->second.height * 0.5f);
+    const SpriteHandle handle = find(id);
+    if (handle != InvalidSprite) {
+        const sf::IntRect& r = mFrameRects[handle];
+        s.setTextureRect(r);
+        s.setOrigin(r.width * 0.5f, r.height * 0.5f);
     }
 
     return s;
 }
+
+void SpriteAtlas::appendQuad(sf::VertexArray& batch, SpriteHandle handle, sf::Vector2f center, float scale, int quarterTurns) const {
+    const sf::IntRect& r = mFrameRects[handle];
+    const float hw = static_cast<float>(r.width) * 0.5f * scale;
+    const float hh = static_cast<float>(r.height) * 0.5f * scale;
+
+    const float u0 = static_cast<float>(r.left);
+    const float v0 = static_cast<float>(r.top);
+    const float u1 = u0 + static_cast<float>(r.width);
+    const float v1 = v0 + static_cast<float>(r.height);
+
+    // Corners clockwise from top-left, with their texture coordinates.
+    sf::Vector2f corners[4] = {{-hw, -hh}, {hw, -hh}, {hw, hh}, {-hw, hh}};
+    const sf::Vector2f uvs[4] = {{u0, v0}, {u1, v0}, {u1, v1}, {u0, v1}};
+
+    // Quarter turns are exact, unlike a float rotation transform.
+    const int turns = ((quarterTurns % 4) + 4) % 4;
+    for (auto& c : corners) {
+        for (int t = 0; t < turns; ++t) {
+            c = {-c.y, c.x};
+        }
+    }
+
+    for (int i = 0; i < 4; ++i) {
+        batch.append(sf::Vertex({center.x + corners[i].x, center.y + corners[i].y}, sf::Color::White, uvs[i]));
+    }
+}
@@ -1,20 +1,77 @@
 #pragma once
 
+#include "AtlasFrames.h" // generated from assets/sprites/atlas.json
+
+#include <SFML/Graphics/Image.hpp>
 #include <SFML/Graphics/Rect.hpp>
 #include <SFML/Graphics/Sprite.hpp>
 #include <SFML/Graphics/Texture.hpp>
+#include <SFML/Graphics/VertexArray.hpp>
 
+#include <array>
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <unordered_map>
+#include <vector>
+
+// Dense index of a frame; resolve names once with find() and keep the handle.
+using SpriteHandle = std::uint16_t;
+constexpr SpriteHandle InvalidSprite = 0xFFFF;
 
+// Runtime texture atlas. Frames come from a sprite sheet (atlas.bmp + atlas.json) and from
+// standalone images added at load time; pack() copies them all into one texture so the whole
+// scene can be drawn from it. Handles stay valid across repacks, rects do not.
+//
+// The stock atlas.json is compiled into AtlasFrames.h at build time: a sheet whose JSON matches
+// it is cut from the constexpr table without parsing, and its frames are looked up by AtlasFrame.
+// Only a modded atlas.json is parsed at runtime.
 class SpriteAtlas {
 public:
+    struct Frame {
+        std::string id;
+        sf::Image image;
+    };
+
+    SpriteAtlas();
+
+    // Adds every frame listed in the JSON (black keyed out once) and repacks.
     bool loadFromFiles(const std::string& imagePath, const std::string& jsonPath);
 
+    // Decodes the sheet and cuts out every frame listed in the JSON, black keyed out. Touches no
+    // atlas, so loader threads can run it.
+    static bool readSheet(const std::string& imagePath, const std::string& jsonPath, std::vector<Frame>& frames);
+    // Same, for a sheet already decoded (keyed in place) and JSON text already in memory.
+    // `name` labels messages. JSON identical to the built-in atlas.json is not parsed.
+    static bool readSheet(sf::Image& sheet, std::string_view json, const std::string& name, std::vector<Frame>& frames);
+    // Stages every frame, then repacks.
+    bool addFrames(const std::vector<Frame>& frames);
+
+    // Stages a standalone image under `id` (replacing any frame of that name). Takes effect
+    // on the next pack(); returns InvalidSprite when the atlas is full.
+    SpriteHandle addImage(const std::string& id, const sf::Image& image);
+
+    // Shelf-packs every staged frame into a single texture. Load-time only.
+    bool pack();
+
+    // Handle of a built-in frame, InvalidSprite until a sheet providing it is added.
+    SpriteHandle find(AtlasFrame frame) const { return mBuiltinHandles[static_cast<std::size_t>(frame)]; }
+    // Name lookups hash a string; use them at load time, not per frame.
+    SpriteHandle find(const std::string& id) const;
     bool has(const std::string& id) const;
     sf::Sprite makeSprite(const std::string& id) const;
 
+    const sf::Texture& texture() const { return mTexture; }
+    const sf::IntRect& frameRect(SpriteHandle handle) const { return mFrameRects[handle]; }
+
+    // Appends one quad (4 vertices, sf::Quads) for `handle` centred on `center`, scaled
+    // uniformly and turned clockwise by `quarterTurns` * 90 degrees. Draw the batch with texture().
+    void appendQuad(sf::VertexArray& batch, SpriteHandle handle, sf::Vector2f center, float scale, int quarterTurns = 0) const;
+
 private:
     sf::Texture mTexture;
-    std::unordered_map<std::string, sf::IntRect> mFrames;
+    std::vector<sf::Image> mImages; // CPU copy of every frame, kept so later additions can repack
+    std::vector<sf::IntRect> mFrameRects;
+    std::unordered_map<std::string, SpriteHandle> mHandles;
+    std::array<SpriteHandle, AtlasFrameCount> mBuiltinHandles; // indexed by AtlasFrame
 };
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+// Bounded lock-free ring for exactly one producer thread and one consumer thread. push() fails
+// instead of blocking when full. Capacity must be a power of two; one slot is never used.
+template <typename T, std::size_t Capacity>
+class SpscQueue {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    // Producer side.
+    bool push(const T& value) {
+        const std::size_t tail = mTail.load(std::memory_order_relaxed);
+        const std::size_t next = (tail + 1) & Mask;
+        if (next == mHeadCache) {
+            mHeadCache = mHead.load(std::memory_order_acquire);
+            if (next == mHeadCache) {
+                return false;
+            }
+        }
+        mSlots[tail] = value;
+        mTail.store(next, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side: oldest element, or null when empty. Valid until pop().
+    const T* front() {
+        const std::size_t head = mHead.load(std::memory_order_relaxed);
+        if (head == mTailCache) {
+            mTailCache = mTail.load(std::memory_order_acquire);
+            if (head == mTailCache) {
+                return nullptr;
+            }
+        }
+        return &mSlots[head];
+    }
+
+    // Consumer side; requires front() != nullptr.
+    void pop() {
+        const std::size_t head = mHead.load(std::memory_order_relaxed);
+        mHead.store((head + 1) & Mask, std::memory_order_release);
+    }
+
+private:
+    static constexpr std::size_t Mask = Capacity - 1;
+
+    std::array<T, Capacity> mSlots{};
+
+    // Producer-owned line: its index plus its last view of the consumer's.
+    alignas(64) std::atomic<std::size_t> mTail{0};
+    std::size_t mHeadCache = 0;
+
+    // Consumer-owned line.
+    alignas(64) std::atomic<std::size_t> mHead{0};
+    std::size_t mTailCache = 0;
+};
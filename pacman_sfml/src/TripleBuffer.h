@@ -0,0 +1,45 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+// Lock-free single-producer / single-consumer hand-off of the newest value. The writer fills
+// writeBuffer() and publish()es it; the reader calls acquire() and then reads readBuffer()
+// undisturbed until its next acquire(). Neither side ever waits, and values the reader did not
+// get to in time are simply skipped.
+template <typename T>
+class TripleBuffer {
+public:
+    // Writer side.
+    T& writeBuffer() { return mSlots[mBack]; }
+
+    void publish() {
+        const std::uint8_t previous = mMiddle.exchange(static_cast<std::uint8_t>(mBack | FreshBit), std::memory_order_acq_rel);
+        mBack = previous & IndexMask;
+    }
+
+    // Reader side. Returns true when a newer value than the current readBuffer() was swapped in.
+    bool acquire() {
+        if ((mMiddle.load(std::memory_order_relaxed) & FreshBit) == 0) {
+            return false;
+        }
+        const std::uint8_t previous = mMiddle.exchange(mFront, std::memory_order_acq_rel);
+        mFront = previous & IndexMask;
+        return true;
+    }
+
+    const T& readBuffer() const { return mSlots[mFront]; }
+
+private:
+    static constexpr std::uint8_t IndexMask = 0x3;
+    static constexpr std::uint8_t FreshBit = 0x4;
+
+    std::array<T, 3> mSlots{};
+
+    // Index of the slot in between, plus FreshBit while it holds an unread value.
+    alignas(64) std::atomic<std::uint8_t> mMiddle{1};
+    // Each index below is owned by one side; separate cache lines keep them from false sharing.
+    alignas(64) std::uint8_t mBack = 2;
+    alignas(64) std::uint8_t mFront = 0;
+};
@@ -0,0 +1,121 @@
+#include "WorkStealingPool.h"
+
+#include <algorithm>
+
+namespace {
+thread_local const WorkStealingPool* tWorkerPool = nullptr;
+thread_local int tWorkerIndex = -1;
+}
+
+WorkStealingPool::WorkStealingPool(unsigned threadCount) {
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    mQueues.reserve(threadCount);
+    for (unsigned i = 0; i < threadCount; ++i) {
+        mQueues.push_back(std::make_unique<Queue>());
+    }
+
+    mThreads.reserve(threadCount);
+    for (unsigned i = 0; i < threadCount; ++i) {
+        mThreads.emplace_back([this, i] { workerLoop(i); });
+    }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    {
+        std::lock_guard<std::mutex> lock(mWakeMutex);
+        mStopping = true;
+    }
+    mWake.notify_all();
+    for (auto& t : mThreads) {
+        t.join();
+    }
+}
+
+int WorkStealingPool::currentWorker() const {
+    return (tWorkerPool == this) ? tWorkerIndex : -1;
+}
+
+void WorkStealingPool::submit(std::function<void()> task) {
+    const int self = currentWorker();
+    const unsigned target = (self >= 0) ? static_cast<unsigned>(self) : mNextQueue.fetch_add(1) % size();
+
+    // Count before pushing so the counters never dip below the deque contents.
+    mPending.fetch_add(1);
+    mQueued.fetch_add(1);
+    {
+        Queue& q = *mQueues[target];
+        std::lock_guard<std::mutex> lock(q.mutex);
+        q.tasks.push_back(std::move(task));
+    }
+
+    // Taking the lock orders this notify after any worker that just saw an empty pool starts waiting.
+    std::lock_guard<std::mutex> lock(mWakeMutex);
+    mWake.notify_one();
+}
+
+void WorkStealingPool::wait() {
+    std::unique_lock<std::mutex> lock(mWakeMutex);
+    mIdle.wait(lock, [this] { return mPending.load() == 0; });
+}
+
+void WorkStealingPool::parallelFor(std::size_t count, std::size_t grain, const std::function<void(unsigned, std::size_t, std::size_t)>& body) {
+    grain = std::max<std::size_t>(grain, 1);
+    for (std::size_t begin = 0; begin < count; begin += grain) {
+        const std::size_t end = std::min(count, begin + grain);
+        submit([&body, begin, end] { body(static_cast<unsigned>(tWorkerIndex), begin, end); });
+    }
+    wait();
+}
+
+bool WorkStealingPool::tryPop(unsigned index, std::function<void()>& out) {
+    {
+        Queue& own = *mQueues[index];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            out = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            mQueued.fetch_sub(1);
+            return true;
+        }
+    }
+
+    const unsigned n = size();
+    for (unsigned k = 1; k < n; ++k) {
+        Queue& victim = *mQueues[(index + k) % n];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            out = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            mQueued.fetch_sub(1);
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkStealingPool::workerLoop(unsigned index) {
+    tWorkerPool = this;
+    tWorkerIndex = static_cast<int>(index);
+
+    std::function<void()> task;
+    for (;;) {
+        if (tryPop(index, task)) {
+            task();
+            task = nullptr;
+            if (mPending.fetch_sub(1) == 1) {
+                std::lock_guard<std::mutex> lock(mWakeMutex);
+                mIdle.notify_all();
+            }
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(mWakeMutex);
+        mWake.wait(lock, [this] { return mStopping || mQueued.load() > 0; });
+        if (mStopping && mQueued.load() == 0) {
+            return;
+        }
+    }
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads, each with its own task deque. A worker pops from the back of
+// its own deque (most recently pushed, cache-warm) and, when that runs dry, steals from the
+// front of the others, so uneven task lengths (short vs. marathon games) balance themselves.
+//
+// Tasks must not throw. wait() and parallelFor() are for the owning thread, not for tasks.
+class WorkStealingPool {
+public:
+    // 0 uses std::thread::hardware_concurrency().
+    explicit WorkStealingPool(unsigned threadCount = 0);
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    unsigned size() const { return static_cast<unsigned>(mQueues.size()); }
+
+    // Queue a task. From a worker it lands on that worker's own deque, otherwise round-robin.
+    void submit(std::function<void()> task);
+
+    // Blocks until every submitted task has finished.
+    void wait();
+
+    // Splits [0, count) into chunks of `grain` and runs body(worker, begin, end) for each,
+    // blocking until all are done. `worker` is in [0, size()), for per-worker scratch state.
+    void parallelFor(std::size_t count, std::size_t grain, const std::function<void(unsigned worker, std::size_t begin, std::size_t end)>& body);
+
+    // Index of the calling worker thread, or -1 when called from outside this pool.
+    int currentWorker() const;
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    void workerLoop(unsigned index);
+    bool tryPop(unsigned index, std::function<void()>& out);
+
+    std::vector<std::unique_ptr<Queue>> mQueues;
+    std::vector<std::thread> mThreads;
+
+    std::mutex mWakeMutex;
+    std::condition_variable mWake;
+    std::condition_variable mIdle;
+
+    std::atomic<std::size_t> mQueued{0};
+    std::atomic<std::size_t> mPending{0};
+    std::atomic<unsigned> mNextQueue{0};
+    bool mStopping = false;
+};
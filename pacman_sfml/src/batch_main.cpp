@@ -0,0 +1,407 @@
+// pacman_batch: plays many independent autopilot games across all cores and aggregates stats.
+//
+//   pacman_batch [--games N] [--seed S] [--threads T] [--max-ticks M] [--map path] [--pack file] [--out file]
+//                [--mode-phases s:s:...] [--frightened-seconds s] [--ghost-speed v] [--frightened-speed v]
+//                [--eaten-speed v] [--fruit-dots n] [--fruit-seconds s] [--sweep name=a,b,...]
+//
+// Game i is seeded from the master seed and i alone, so the summary is identical for any
+// thread count. Games still running after M ticks are counted as timeouts. --pack reads maps from
+// an asset pack, mapped once and shared by every worker. The maze is loaded once too, and every
+// worker plays on a copy that shares its NavTable.
+//
+// The tuning options override SimConfig for every game. Each --sweep repeats the whole batch
+// once per listed value of one tuning option (named without the dashes); several sweeps run
+// every combination, and each summary is preceded by the swept values it used.
+
+#include "AssetPack.h"
+#include "Autopilot.h"
+#include "Simulation.h"
+#include "WorkStealingPool.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+void printUsage() {
+    std::cerr << "usage: pacman_batch [--games N] [--seed S] [--threads T] [--max-ticks M] [--map path] [--pack file] [--out file]\n"
+                 "                    [--mode-phases s:s:...] [--frightened-seconds s] [--ghost-speed v] [--frightened-speed v]\n"
+                 "                    [--eaten-speed v] [--fruit-dots n] [--fruit-seconds s] [--sweep name=a,b,...]\n";
+}
+
+bool parseFloat(const std::string& text, float& out) {
+    char* end = nullptr;
+    out = std::strtof(text.c_str(), &end);
+    return !text.empty() && *end == '\0';
+}
+
+// Sets the SimConfig field behind a tuning option. Mode phases are colon-separated seconds;
+// phases left out repeat the last one given.
+bool setConfigValue(SimConfig& config, const std::string& name, const std::string& value) {
+    if (name == "mode-phases") {
+        auto& phases = config.modePhasesSeconds;
+        std::size_t count = 0;
+        std::size_t begin = 0;
+        for (;;) {
+            const std::size_t colon = value.find(':', begin);
+            if (count == phases.size() || !parseFloat(value.substr(begin, colon - begin), phases[count])) {
+                return false;
+            }
+            ++count;
+            if (colon == std::string::npos) {
+                break;
+            }
+            begin = colon + 1;
+        }
+        std::fill(phases.begin() + static_cast<std::ptrdiff_t>(count), phases.end(), phases[count - 1]);
+        return true;
+    }
+    if (name == "fruit-dots") {
+        char* end = nullptr;
+        const long dots = std::strtol(value.c_str(), &end, 10);
+        if (value.empty() || *end != '\0') {
+            return false;
+        }
+        config.fruitDots = static_cast<int>(dots);
+        return true;
+    }
+
+    float* field = nullptr;
+    if (name == "frightened-seconds") field = &config.frightenedSeconds;
+    else if (name == "ghost-speed") field = &config.ghostSpeed;
+    else if (name == "frightened-speed") field = &config.frightenedGhostSpeed;
+    else if (name == "eaten-speed") field = &config.eatenGhostSpeed;
+    else if (name == "fruit-seconds") field = &config.fruitSeconds;
+    return field != nullptr && parseFloat(value, *field);
+}
+
+struct Sweep {
+    std::string name;
+    std::vector<std::string> values;
+};
+
+// "name=a,b,c"; every value must be valid for the option.
+bool parseSweep(const std::string& text, Sweep& out) {
+    const std::size_t eq = text.find('=');
+    if (eq == std::string::npos) {
+        return false;
+    }
+    out.name = text.substr(0, eq);
+    out.values.clear();
+    std::size_t begin = eq + 1;
+    for (;;) {
+        const std::size_t comma = text.find(',', begin);
+        out.values.push_back(text.substr(begin, comma - begin));
+        SimConfig scratch;
+        if (!setConfigValue(scratch, out.name, out.values.back())) {
+            return false;
+        }
+        if (comma == std::string::npos) {
+            return true;
+        }
+        begin = comma + 1;
+    }
+}
+
+// SplitMix64: decorrelates neighbouring game indices into independent seeds.
+std::uint64_t splitMix64(std::uint64_t x) {
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+constexpr std::size_t GhostCount = 4;
+constexpr std::size_t ModeCount = 4;
+constexpr std::size_t MaxLevelBucket = 32;
+
+const char* ghostName(std::size_t id) {
+    static const char* names[GhostCount] = {"blinky", "pinky", "inky", "clyde"};
+    return names[id];
+}
+
+const char* modeName(std::size_t mode) {
+    static const char* names[ModeCount] = {"scatter", "chase", "frightened", "eaten"};
+    return names[mode];
+}
+
+// Integer-only accumulators so merging per-worker results is exact and order-independent.
+struct BatchStats {
+    std::uint64_t games = 0;
+    std::uint64_t timeouts = 0;
+
+    std::uint64_t scoreSum = 0;
+    std::uint64_t scoreSqSum = 0;
+    std::uint64_t scoreMin = std::numeric_limits<std::uint64_t>::max();
+    std::uint64_t scoreMax = 0;
+
+    std::uint64_t ticksSum = 0;
+    std::uint64_t ticksMin = std::numeric_limits<std::uint64_t>::max();
+    std::uint64_t ticksMax = 0;
+
+    // Index = level reached (last bucket collects everything beyond).
+    std::array<std::uint64_t, MaxLevelBucket + 1> levels{};
+    // [ghost][ghost mode] of every life lost.
+    std::array<std::array<std::uint64_t, ModeCount>, GhostCount> deaths{};
+
+    void addGame(std::uint64_t score, std::uint64_t ticks, int level, bool timedOut) {
+        ++games;
+        if (timedOut) ++timeouts;
+
+        scoreSum += score;
+        scoreSqSum += score * score;
+        scoreMin = std::min(scoreMin, score);
+        scoreMax = std::max(scoreMax, score);
+
+        ticksSum += ticks;
+        ticksMin = std::min(ticksMin, ticks);
+        ticksMax = std::max(ticksMax, ticks);
+
+        levels[std::min<std::size_t>(static_cast<std::size_t>(std::max(level, 0)), MaxLevelBucket)] += 1;
+    }
+
+    void merge(const BatchStats& o) {
+        games += o.games;
+        timeouts += o.timeouts;
+        scoreSum += o.scoreSum;
+        scoreSqSum += o.scoreSqSum;
+        scoreMin = std::min(scoreMin, o.scoreMin);
+        scoreMax = std::max(scoreMax, o.scoreMax);
+        ticksSum += o.ticksSum;
+        ticksMin = std::min(ticksMin, o.ticksMin);
+        ticksMax = std::max(ticksMax, o.ticksMax);
+        for (std::size_t i = 0; i < levels.size(); ++i) {
+            levels[i] += o.levels[i];
+        }
+        for (std::size_t g = 0; g < GhostCount; ++g) {
+            for (std::size_t m = 0; m < ModeCount; ++m) {
+                deaths[g][m] += o.deaths[g][m];
+            }
+        }
+    }
+};
+
+void writeSummary(std::ostream& out, const BatchStats& s, std::uint64_t masterSeed, std::uint64_t maxTicks) {
+    const double n = static_cast<double>(std::max<std::uint64_t>(s.games, 1));
+    const double scoreMean = static_cast<double>(s.scoreSum) / n;
+    const double scoreVar = std::max(0.0, static_cast<double>(s.scoreSqSum) / n - scoreMean * scoreMean);
+    const double tickSeconds = static_cast<double>(Simulation::FixedDt);
+
+    out << "games " << s.games << "\n";
+    out << "master_seed " << masterSeed << "\n";
+    out << "max_ticks " << maxTicks << "\n";
+    out << "timeouts " << s.timeouts << "\n";
+    if (s.games == 0) {
+        return;
+    }
+
+    out << "score_mean " << scoreMean << "\n";
+    out << "score_stddev " << std::sqrt(scoreVar) << "\n";
+    out << "score_min " << s.scoreMin << "\n";
+    out << "score_max " << s.scoreMax << "\n";
+
+    out << "survival_seconds_mean " << static_cast<double>(s.ticksSum) / n * tickSeconds << "\n";
+    out << "survival_seconds_min " << static_cast<double>(s.ticksMin) * tickSeconds << "\n";
+    out << "survival_seconds_max " << static_cast<double>(s.ticksMax) * tickSeconds << "\n";
+
+    for (std::size_t level = 0; level < s.levels.size(); ++level) {
+        if (s.levels[level] != 0) {
+            out << "level_reached_" << level << (level == MaxLevelBucket ? "_plus " : " ") << s.levels[level] << "\n";
+        }
+    }
+
+    std::uint64_t totalDeaths = 0;
+    for (const auto& perMode : s.deaths) {
+        for (std::uint64_t d : perMode) {
+            totalDeaths += d;
+        }
+    }
+    out << "deaths_total " << totalDeaths << "\n";
+    for (std::size_t g = 0; g < GhostCount; ++g) {
+        for (std::size_t m = 0; m < ModeCount; ++m) {
+            if (s.deaths[g][m] != 0) {
+                out << "deaths_" << ghostName(g) << "_" << modeName(m) << " " << s.deaths[g][m] << "\n";
+            }
+        }
+    }
+}
+
+// Everything a worker reuses from game to game.
+struct Worker {
+    Simulation sim;
+    Autopilot pilot;
+    BatchStats stats;
+};
+
+// Plays games [0, games) with each worker's current config and merges their results.
+BatchStats runBatch(WorkStealingPool& pool, std::vector<std::unique_ptr<Worker>>& workers, std::uint64_t games,
+                    std::uint64_t masterSeed, std::uint64_t maxTicks) {
+    for (auto& w : workers) {
+        w->stats = BatchStats{};
+    }
+
+    pool.parallelFor(games, 16, [&](unsigned workerIndex, std::size_t begin, std::size_t end) {
+        Worker& w = *workers[workerIndex];
+        Simulation& sim = w.sim;
+
+        for (std::size_t game = begin; game < end; ++game) {
+            const std::uint64_t seed = splitMix64(masterSeed ^ splitMix64(game));
+            sim.seed(static_cast<std::uint32_t>(seed));
+            sim.startNewGame();
+            w.pilot.reset(static_cast<std::uint32_t>(seed >> 32));
+
+            std::uint64_t ticks = 0;
+            while (!sim.isGameOver() && ticks < maxTicks) {
+                const Direction d = w.pilot.decide(sim);
+                if (d != Direction::None) {
+                    sim.requestDirection(d);
+                }
+                sim.update(Simulation::FixedDt);
+                ++ticks;
+
+                for (SimEvent e : sim.events()) {
+                    if (e == SimEvent::PlayerDied) {
+                        w.stats.deaths[static_cast<std::size_t>(sim.lastKiller())][static_cast<std::size_t>(sim.lastKillerMode())] += 1;
+                    }
+                }
+            }
+
+            w.stats.addGame(static_cast<std::uint64_t>(std::max(sim.score(), 0)), ticks, sim.level(), !sim.isGameOver());
+        }
+    });
+
+    BatchStats total;
+    for (const auto& w : workers) {
+        total.merge(w->stats);
+    }
+    return total;
+}
+
+// Applies the sweep values selected by a mixed-radix combination index (last sweep varies
+// fastest) and describes them in `label`, one "sweep <name> <value>" line each.
+SimConfig sweepConfig(const SimConfig& base, const std::vector<Sweep>& sweeps, std::size_t combination, std::string& label) {
+    SimConfig config = base;
+    label.clear();
+    for (std::size_t s = sweeps.size(); s-- > 0;) {
+        const std::string& value = sweeps[s].values[combination % sweeps[s].values.size()];
+        combination /= sweeps[s].values.size();
+        setConfigValue(config, sweeps[s].name, value);
+        label.insert(0, "sweep " + sweeps[s].name + " " + value + "\n");
+    }
+    return config;
+}
+}
+
+int main(int argc, char** argv) {
+    std::uint64_t games = 1000;
+    std::uint64_t masterSeed = 1;
+    unsigned threads = 0;
+    std::uint64_t maxTicks = 60ull * 60ull * 30ull;
+    std::string mapPath = "assets/maps/level1.txt";
+    std::string packPath;
+    std::string outPath;
+    SimConfig baseConfig;
+    std::vector<Sweep> sweeps;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool hasValue = (i + 1 < argc);
+        if (arg == "--games" && hasValue) {
+            games = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--seed" && hasValue) {
+            masterSeed = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--threads" && hasValue) {
+            threads = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--max-ticks" && hasValue) {
+            maxTicks = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--map" && hasValue) {
+            mapPath = argv[++i];
+        } else if (arg == "--pack" && hasValue) {
+            packPath = argv[++i];
+        } else if (arg == "--out" && hasValue) {
+            outPath = argv[++i];
+        } else if (arg == "--sweep" && hasValue) {
+            sweeps.emplace_back();
+            if (!parseSweep(argv[++i], sweeps.back())) {
+                std::cerr << "Invalid sweep: " << argv[i] << "\n";
+                return 2;
+            }
+        } else if (arg.compare(0, 2, "--") == 0 && hasValue && setConfigValue(baseConfig, arg.substr(2), argv[i + 1])) {
+            ++i;
+        } else {
+            printUsage();
+            return 2;
+        }
+    }
+
+    AssetPack pack;
+    if (!packPath.empty() && !pack.open(packPath)) {
+        std::cerr << "Cannot use asset pack: " << packPath << "\n";
+        return 1;
+    }
+
+    WorkStealingPool pool(threads);
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    workers.reserve(pool.size());
+    for (unsigned i = 0; i < pool.size(); ++i) {
+        auto w = std::make_unique<Worker>();
+        w->sim.setMapPaths(mapPath, "assets/maps/fallback.txt");
+        if (pack.isOpen()) {
+            w->sim.setAssetPack(&pack);
+        }
+        workers.push_back(std::move(w));
+    }
+
+    // Load the maze once; the other workers get copies that share its NavTable.
+    workers.front()->sim.loadLevel(1);
+    for (std::size_t i = 1; i < workers.size(); ++i) {
+        workers[i]->sim.setMap(workers.front()->sim.map());
+    }
+
+    std::ofstream out;
+    if (!outPath.empty()) {
+        out.open(outPath);
+        if (!out) {
+            std::cerr << "Failed to open summary file: " << outPath << "\n";
+            return 1;
+        }
+    }
+
+    std::size_t combinations = 1;
+    for (const Sweep& sweep : sweeps) {
+        combinations *= sweep.values.size();
+    }
+
+    std::string label;
+    for (std::size_t combination = 0; combination < combinations; ++combination) {
+        const SimConfig config = sweepConfig(baseConfig, sweeps, combination, label);
+        for (auto& w : workers) {
+            w->sim.setConfig(config);
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        const BatchStats total = runBatch(pool, workers, games, masterSeed, maxTicks);
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        std::cout << label;
+        writeSummary(std::cout, total, masterSeed, maxTicks);
+        std::cout << "elapsed " << seconds << " s on " << pool.size() << " threads ("
+                  << (seconds > 0.0 ? static_cast<double>(total.games) / seconds : 0.0) << " games/s)\n";
+
+        if (out.is_open()) {
+            out << label;
+            writeSummary(out, total, masterSeed, maxTicks);
+        }
+    }
+    return 0;
+}
@@ -1,40 +1,67 @@
 #include "Game.h"
+#include "Log.h"
 
-#include <iostream>
-#include <fstream>
 #include <cstdlib>
+#include <exception>
+#include <string>
 
-int main() {
-    // Open log file for debugging
-    std::ofstream logFile("pacman_debug.log");
-    if (!logFile) {
-        std::cerr << "Failed to open log file!" << std::endl;
-    }
-    
-    auto log = [&](const std::string& msg) {
-        std::cout << msg << std::endl;
-        logFile << msg << std::endl;
-        logFile.flush();
-    };
-    
-    log("=== Pac-Man Debug Log ===");
-    log("Starting application...");
-    
+namespace {
+int runGame(int argc, char** argv) {
     try {
-        log("Creating Game object...");
+        PACMAN_LOG_INFO("Creating Game object...");
         Game game;
-        log("Game object created successfully!");
+        PACMAN_LOG_INFO("Game object created successfully!");
+
+        // Optional input capture / playback: --record <file> or --replay <file>.
+        // Latency measurement: --latency-log <file>, with --no-vsync / --fps-limit <n> to compare.
+        // Profiling (PACMAN_PROFILE builds): --trace <file>, written on F9 and at exit.
+        for (int i = 1; i < argc; ++i) {
+            const std::string arg = argv[i];
+            const bool hasValue = (i + 1 < argc);
+            if (arg == "--record" && hasValue) {
+                if (!game.recordTo(argv[++i])) {
+                    return 1;
+                }
+            } else if (arg == "--replay" && hasValue) {
+                if (!game.playReplay(argv[++i])) {
+                    return 1;
+                }
+            } else if (arg == "--latency-log" && hasValue) {
+                if (!game.measureLatency(argv[++i])) {
+                    return 1;
+                }
+            } else if (arg == "--trace" && hasValue) {
+                game.traceTo(argv[++i]);
+            } else if (arg == "--no-vsync") {
+                game.setVsync(false);
+            } else if (arg == "--fps-limit" && hasValue) {
+                game.setFramerateLimit(static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10)));
+            }
+        }
         
-        log("Starting game loop...");
-        int result = game.run();
-        log("Game exited with code: " + std::to_string(result));
+        PACMAN_LOG_INFO("Starting game loop...");
+        const int result = game.run();
+        PACMAN_LOG_INFO("Game exited with code: %d", result);
         
         return result;
     } catch (const std::exception& e) {
-        log("EXCEPTION: " + std::string(e.what()));
+        PACMAN_LOG_ERROR("EXCEPTION: %s", e.what());
         return 1;
     } catch (...) {
-        log("UNKNOWN EXCEPTION occurred!");
+        PACMAN_LOG_ERROR("UNKNOWN EXCEPTION occurred!");
         return 1;
     }
 }
+}
+
+int main(int argc, char** argv) {
+    // Lines are written to stderr and pacman_debug.log by a background thread.
+    Log::start("pacman_debug.log");
+    Log::setThreadName("main");
+    PACMAN_LOG_INFO("=== Pac-Man Debug Log ===");
+    PACMAN_LOG_INFO("Starting application...");
+
+    const int result = runGame(argc, argv);
+    Log::stop();
+    return result;
+}
@@ -0,0 +1,25 @@
+// pacman_pack: bundles an asset directory into one indexed pack file for AssetPack.
+#include "AssetPack.h"
+
+#include <iostream>
+#include <string>
+
+int main(int argc, char** argv) {
+    if (argc != 3) {
+        std::cerr << "Usage: pacman_pack <asset directory> <output pack>\n";
+        return 2;
+    }
+
+    const std::string directory = argv[1];
+    const std::string outputPath = argv[2];
+    if (!AssetPack::build(directory, outputPath)) {
+        return 1;
+    }
+
+    AssetPack pack;
+    if (!pack.open(outputPath)) {
+        return 1;
+    }
+    std::cout << "Packed " << pack.entryCount() << " files from " << directory << " into " << outputPath << "\n";
+    return 0;
+}
@@ -0,0 +1,291 @@
+// pacman_sim: runs the gameplay simulation without a window, audio or GL context.
+//
+//   pacman_sim [--ticks N] [--seed S] [--map path] [--pack file] [--no-autopilot] [--quiet]
+//              [--record file] [--replay file] [--trace file] [--assert-zero-alloc]
+//              [--check-rollback N]
+//
+// Games are restarted on game over until N ticks have been simulated. --record writes the
+// session's inputs as a replay; --replay runs a recorded session instead (seed, map and ticks
+// come from the file; --map overrides the recorded map path). --trace writes the newest profiler
+// zones as Chrome trace JSON (PACMAN_PROFILE builds only). --assert-zero-alloc counts heap
+// allocations inside every tick after a one-minute warm-up and fails if there were any. --pack
+// reads maps from an asset pack built by pacman_pack; paths it lacks still load from disk.
+// --check-rollback snapshots the state every N ticks, restores it after N more, replays the same
+// inputs and fails unless the result matches the state it rolled back from; it reports how many
+// of those cycles run per second and how many heap allocations they made after the warm-up.
+
+#include "AllocationCounter.h"
+#include "AssetPack.h"
+#include "Autopilot.h"
+#include "Profiler.h"
+#include "Replay.h"
+#include "Simulation.h"
+#include "Snapshot.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+// Level loads, cache fills and first-use container growth all happen well inside a minute.
+constexpr std::uint64_t AllocWarmupTicks = 60 * 60;
+
+void printUsage() {
+    std::cerr << "usage: pacman_sim [--ticks N] [--seed S] [--map path] [--pack file] [--no-autopilot] [--quiet]\n"
+                 "                  [--record file] [--replay file] [--trace file]\n"
+                 "                  [--assert-zero-alloc] [--check-rollback N]\n";
+}
+
+// Zeroes the padding too, so two snapshots of the same state compare equal with memcmp.
+bool saveZeroed(const Simulation& sim, SimSnapshot& out) {
+    std::memset(static_cast<void*>(&out), 0, sizeof(out));
+    return sim.saveSnapshot(out);
+}
+}
+
+int main(int argc, char** argv) {
+    std::uint64_t ticks = 60ull * 60ull * 10ull;
+    std::uint32_t seed = 1;
+    std::string mapPath = "assets/maps/level1.txt";
+    bool mapGiven = false;
+    std::string packPath;
+    std::string recordPath;
+    std::string replayPath;
+    std::string tracePath;
+    bool autopilot = true;
+    bool quiet = false;
+    bool assertZeroAlloc = false;
+    std::uint64_t rollbackTicks = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool hasValue = (i + 1 < argc);
+        if (arg == "--ticks" && hasValue) {
+            ticks = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--seed" && hasValue) {
+            seed = static_cast<std::uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--map" && hasValue) {
+            mapPath = argv[++i];
+            mapGiven = true;
+        } else if (arg == "--pack" && hasValue) {
+            packPath = argv[++i];
+        } else if (arg == "--record" && hasValue) {
+            recordPath = argv[++i];
+        } else if (arg == "--replay" && hasValue) {
+            replayPath = argv[++i];
+        } else if (arg == "--trace" && hasValue) {
+            tracePath = argv[++i];
+        } else if (arg == "--no-autopilot") {
+            autopilot = false;
+        } else if (arg == "--quiet") {
+            quiet = true;
+        } else if (arg == "--assert-zero-alloc") {
+            assertZeroAlloc = true;
+        } else if (arg == "--check-rollback" && hasValue) {
+            rollbackTicks = std::strtoull(argv[++i], nullptr, 10);
+        } else {
+            printUsage();
+            return 2;
+        }
+    }
+
+    ReplayReader replay;
+    const bool replaying = !replayPath.empty();
+    if (replaying) {
+        if (!replay.open(replayPath)) {
+            return 1;
+        }
+        seed = replay.seed();
+        if (!mapGiven) {
+            mapPath = replay.mapPath();
+        }
+    }
+
+    AssetPack pack;
+    if (!packPath.empty() && !pack.open(packPath)) {
+        std::cerr << "Cannot use asset pack: " << packPath << "\n";
+        return 1;
+    }
+
+    Simulation sim;
+    sim.setMapPaths(mapPath, "assets/maps/fallback.txt");
+    if (pack.isOpen()) {
+        sim.setAssetPack(&pack);
+    }
+    sim.seed(seed);
+
+    ReplayWriter recorder;
+    if (!recordPath.empty()) {
+        if (!recorder.open(recordPath, seed, mapPath)) {
+            return 1;
+        }
+        sim.setRecorder(&recorder);
+    }
+
+    Autopilot pilot(seed);
+
+    int games = 1;
+    int bestScore = 0;
+    std::uint64_t totalScore = 0;
+    std::uint64_t simulated = 0;
+
+    std::uint64_t steadyAllocations = 0;
+    std::uint64_t allocatingTicks = 0;
+
+    // --check-rollback: [window start, expected end] in the ring, inputs fed since the start.
+    SnapshotRing rollbackRing(2);
+    SimSnapshot replayed;
+    std::vector<Direction> rollbackInputs;
+    rollbackInputs.reserve(rollbackTicks);
+    bool rollbackOpen = false;
+    std::uint64_t rollbackCycles = 0;
+    std::uint64_t rollbackMismatches = 0;
+    std::uint64_t rollbackAllocations = 0;
+    double rollbackSeconds = 0.0;
+
+    const auto start = std::chrono::steady_clock::now();
+
+    if (!replaying) {
+        sim.startNewGame();
+    }
+
+    for (;;) {
+        const std::uint64_t allocationsBefore = AllocationCounter::thisThread();
+        if (replaying) {
+            Direction requested = Direction::None;
+            const ReplayStep step = replay.next(requested);
+            if (step == ReplayStep::End) {
+                break;
+            }
+            if (step == ReplayStep::NewGame) {
+                sim.startNewGame();
+                rollbackOpen = false;
+                continue;
+            }
+            sim.requestDirection(requested);
+        } else {
+            if (simulated >= ticks) {
+                break;
+            }
+            if (autopilot) {
+                const Direction d = pilot.decide(sim);
+                if (d != Direction::None) {
+                    sim.requestDirection(d);
+                }
+            }
+        }
+
+        if (rollbackTicks > 0 && !rollbackOpen) {
+            rollbackRing.clear();
+            if (!saveZeroed(sim, rollbackRing.push())) {
+                std::cerr << "--check-rollback: map too large to snapshot\n";
+                return 1;
+            }
+            rollbackInputs.clear();
+            rollbackOpen = true;
+        }
+        if (rollbackOpen) {
+            rollbackInputs.push_back(sim.player().requestedDirection());
+        }
+
+        const bool wasGameOver = sim.isGameOver();
+        sim.update(Simulation::FixedDt);
+        ++simulated;
+
+        if (assertZeroAlloc && simulated > AllocWarmupTicks) {
+            const std::uint64_t allocations = AllocationCounter::thisThread() - allocationsBefore;
+            if (allocations != 0) {
+                steadyAllocations += allocations;
+                if (allocatingTicks++ == 0) {
+                    std::cerr << "first steady-state allocation at tick " << simulated << " (" << allocations << " allocations)\n";
+                }
+            }
+        }
+
+        if (rollbackOpen && rollbackInputs.size() == rollbackTicks) {
+            const std::uint64_t rollbackAllocationsBefore = AllocationCounter::thisThread();
+            const auto rollbackStart = std::chrono::steady_clock::now();
+
+            saveZeroed(sim, rollbackRing.push());
+            sim.setRecorder(nullptr);
+            sim.restoreSnapshot(rollbackRing.fromNewest(1));
+            for (const Direction d : rollbackInputs) {
+                sim.requestDirection(d);
+                sim.update(Simulation::FixedDt);
+            }
+            saveZeroed(sim, replayed);
+            if (std::memcmp(&replayed, &rollbackRing.fromNewest(0), sizeof(replayed)) != 0) {
+                if (rollbackMismatches++ == 0) {
+                    std::cerr << "first rollback mismatch replaying ticks " << rollbackRing.fromNewest(1).tick << ".."
+                              << rollbackRing.fromNewest(0).tick << "\n";
+                }
+                // Carry on from the state the run really reached.
+                sim.restoreSnapshot(rollbackRing.fromNewest(0));
+            }
+            if (recorder.isOpen()) {
+                sim.setRecorder(&recorder);
+            }
+
+            rollbackSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - rollbackStart).count();
+            if (simulated > AllocWarmupTicks) {
+                rollbackAllocations += AllocationCounter::thisThread() - rollbackAllocationsBefore;
+            }
+            ++rollbackCycles;
+            rollbackOpen = false;
+        }
+
+        // Replays recorded by the game keep a few ticks after game over; count the game once.
+        if (sim.isGameOver() && !wasGameOver) {
+            if (!quiet) {
+                std::cout << "game " << games << ": score " << sim.score() << ", level " << sim.level()
+                          << ", ticks " << sim.tick() << "\n";
+            }
+            totalScore += static_cast<std::uint64_t>(sim.score());
+            if (sim.score() > bestScore) bestScore = sim.score();
+
+            ++games;
+            if (!replaying) {
+                sim.startNewGame();
+                pilot.reset(seed + static_cast<std::uint32_t>(games));
+                rollbackOpen = false;
+            }
+        }
+    }
+
+    if (!recorder.close()) {
+        return 1;
+    }
+
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "ticks " << simulated << " in " << seconds << " s (" << (seconds > 0.0 ? static_cast<double>(simulated) / seconds : 0.0)
+              << " ticks/s)\n";
+    std::cout << "games finished " << (games - 1) << ", best score " << bestScore << ", total score " << totalScore << "\n";
+    std::cout << "current game: score " << sim.score() << ", lives " << sim.lives() << ", level " << sim.level() << "\n";
+
+    if (assertZeroAlloc) {
+        const std::uint64_t checked = simulated > AllocWarmupTicks ? simulated - AllocWarmupTicks : 0;
+        std::cout << "steady-state allocations " << steadyAllocations << " in " << allocatingTicks << " of " << checked << " ticks\n";
+        if (steadyAllocations != 0) {
+            return 1;
+        }
+    }
+
+    if (rollbackTicks > 0) {
+        std::cout << "rollback checks " << rollbackCycles << " of " << rollbackTicks << " ticks ("
+                  << (rollbackSeconds > 0.0 ? static_cast<double>(rollbackCycles) / rollbackSeconds : 0.0)
+                  << " cycles/s), mismatches " << rollbackMismatches << ", steady-state allocations " << rollbackAllocations << "\n";
+        if (rollbackMismatches != 0 || rollbackAllocations != 0) {
+            return 1;
+        }
+    }
+
+    if (!tracePath.empty() && !Profiler::writeChromeTrace(tracePath)) {
+        return 1;
+    }
+    return 0;
+}